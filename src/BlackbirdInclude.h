@@ -11,6 +11,7 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cpl_conv.h>
 #include <cstring>
@@ -34,6 +35,13 @@
 #include <unordered_map>
 #include <valarray>
 #include <vector>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <cstdint>
 
 //*****************************************************************
 // Global Variables (necessary, but minimized, evils)
@@ -66,6 +74,9 @@ const double DAYS_PER_MONTH[12] = {31,28,31,30,31,30,31,31,30,31,30,31};   ///<
 
 //decision constants
 const double  TIME_CORRECTION         =0.0001;                                  ///< [d]      offset for time series min/max functions
+const double  CRIT_LADDER_BASE_FLOW   =1.0;                                     ///< [m3/s]   flow of rung 0 of the critical depth flow ladder
+const double  CRIT_LADDER_RATIO       =1.005;                                   ///< [-]      ratio of flows of consecutive rungs of the critical depth flow ladder
+const int     NORMAL_RATING_SUBDIV    =8;                                       ///< [-]      number of rating points per interval of the depth table in normal depth ratings
 
 //*****************************************************************
 //Exit Strategies
@@ -239,6 +250,150 @@ struct ExhaustiveWSLResult {
     double wsl_estimated;  // chosen WSL based on Froude threshold
 };
 
+// structure for the working state of a single flow profile solve, allowing independent profiles to be computed concurrently
+struct profile_workspace {
+  int flow;                           // index of flow profile being computed
+  std::vector<hydraulic_output> mm;   // working hydraulic state of each streamnode, indexed as in bbsn
+  double peak_hrs_min;                // minimum hydraulic output peak hours required for all streamnodes in profile
+  double peak_hrs_max;                // maximum hydraulic output peak hours required for all streamnodes in profile
+  std::mutex peak_hrs_mutex;          // guards peak_hrs_min and peak_hrs_max when branches of the profile are computed concurrently
+  std::vector<double> prior_wsl;      // prior wsl of each streamnode used to warm start wsl solves, PLACEHOLDER if none. empty if warm start is off
+  std::atomic<long> num_warm_solves;  // number of brent or newton wsl solves given a prior wsl
+  std::atomic<long> warm_evals;       // number of residual evaluations used by warm started solves
+  std::atomic<long> num_cold_solves;  // number of brent or newton wsl solves without a prior wsl
+  std::atomic<long> cold_evals;       // number of residual evaluations used by cold started solves
+  std::atomic<long> num_crit_cached;  // number of critical depths interpolated from critical_depth_curve
+  std::atomic<long> num_crit_exact;   // number of critical depths recomputed exactly as the cached error bound was exceeded
+  std::vector<char> moved;            // 1 if each streamnode was re-solved in an incremental solve, indexed as in bbsn. empty for a full solve
+  std::atomic<long> num_reused;       // number of streamnodes whose prior result was kept in an incremental solve
+
+  profile_workspace(int f, std::size_t num_sn)
+    : flow(f), mm(num_sn), peak_hrs_min(PLACEHOLDER), peak_hrs_max(PLACEHOLDER), prior_wsl(),
+      num_warm_solves(0), warm_evals(0), num_cold_solves(0), cold_evals(0),
+      num_crit_cached(0), num_crit_exact(0), moved(), num_reused(0) {}
+};
+
+// structure for the lazily built curve of critical depth versus flow of a streamnode, sampled on a log-spaced flow ladder
+// rung k of the ladder is the flow CRIT_LADDER_BASE_FLOW * CRIT_LADDER_RATIO^k
+struct critical_depth_curve {
+  std::map<int, double> rungs;  // critical depth at each rung of the ladder computed so far, keyed by rung index
+  std::mutex mutex;             // guards rungs when the streamnode is computed by concurrent flow profiles
+
+  critical_depth_curve() : rungs() {}
+  critical_depth_curve(const critical_depth_curve &other) : rungs(other.rungs) {}
+  critical_depth_curve &operator=(const critical_depth_curve &other) { rungs = other.rungs; return *this; }
+};
+
+// structure for the precomputed traversal of the stream network tree upstream of a boundary condition streamnode
+// streamnodes are stored in computation order as runs of branches; each branch is walked upstream along
+// upnodeID1 from its first streamnode, and the upnodeID2 branch of a junction may start once the junction is computed
+struct compiled_tree {
+  int bc_ind;               // index in bbbc of the boundary condition of the tree
+  std::vector<int> order;   // index in bbsn of each streamnode of the tree, in computation order
+  std::vector<int> down;    // index in bbsn of the streamnode one node downstream of each entry of order (itself for the boundary condition streamnode)
+  std::vector<int> branch;  // position in order of the first streamnode of each branch. branch b ends where branch b+1 starts
+  std::vector<int> spawn;   // branch starting upstream of each entry of order if it is a junction, -1 otherwise
+};
+
+// structure for a branch of a compiled_tree to be computed, used as a task in compute_flow_profile
+struct branch_task {
+  int tree;                 // index of compiled tree containing the branch
+  int branch;               // index of branch within the compiled tree
+};
+
+// structure for a single hydraulic state evaluation at a streamnode, used within solvers in place of hydraulic_output
+struct hydraulic_state {
+  double flow;
+  double wsl;
+  double depth;
+  double area;
+  double top_width;
+  double hyd_depth;
+  double k_total;
+  double alpha;
+  double length_effective;
+  double length_effectiveadjusted;
+  double velocity;
+  double velocity_head;
+  double froude;
+  double sf;
+  double sf_avg;
+  double length_energyloss;
+  double head_loss;
+
+  // derivatives with respect to wsl, exact for the linear interpolation within the current table bracket
+  double d_area;
+  double d_k_total;
+  double d_alpha;
+  double d_length_effective;
+  double d_length_effectiveadjusted;
+  double d_velocity;
+  double d_velocity_head;
+  double d_sf;
+  double d_sf_avg;
+  double d_length_energyloss;
+  double d_head_loss;
+
+  // Constructor
+  hydraulic_state()
+      : flow(0.0), wsl(0.0), depth(0.0), area(0.0), top_width(0.0),
+        hyd_depth(0.0), k_total(0.0), alpha(0.0), length_effective(0.0),
+        length_effectiveadjusted(0.0), velocity(0.0), velocity_head(0.0),
+        froude(0.0), sf(0.0), sf_avg(0.0), length_energyloss(0.0),
+        head_loss(0.0), d_area(0.0), d_k_total(0.0), d_alpha(0.0),
+        d_length_effective(0.0), d_length_effectiveadjusted(0.0),
+        d_velocity(0.0), d_velocity_head(0.0), d_sf(0.0), d_sf_avg(0.0),
+        d_length_energyloss(0.0), d_head_loss(0.0) {}
+};
+
+// structure for columnar storage of a preprocessed hydraulic table, built once from the rows of depthdf
+struct hydraulic_table {
+  std::vector<double> wsl;
+  std::vector<double> depth;
+  std::vector<double> k_total;
+  std::vector<double> alpha;
+  std::vector<double> area;
+  std::vector<double> hradius;
+  std::vector<double> wet_perimeter;
+  std::vector<double> manning_composite;
+  std::vector<double> length_effective;
+  std::vector<double> hyd_depth;
+  std::vector<double> top_width;
+  std::vector<double> k_total_areaconv;
+  std::vector<double> k_total_disconv;
+  std::vector<double> k_total_roughconv;
+  std::vector<double> alpha_areaconv;
+  std::vector<double> alpha_disconv;
+  std::vector<double> alpha_roughconv;
+  std::vector<double> nc_equalforce;
+  std::vector<double> nc_equalvelocity;
+  std::vector<double> nc_wavgwp;
+  std::vector<double> nc_wavgarea;
+  std::vector<double> nc_wavgconv;
+  double wsl_min;
+  double wsl_max;
+  double wsl_step;    // spacing of wsl column if rows are uniformly spaced, PLACEHOLDER otherwise
+  double depth_step;  // spacing of depth column if rows are uniformly spaced, PLACEHOLDER otherwise
+
+  // Constructor
+  hydraulic_table() : wsl_min(PLACEHOLDER), wsl_max(PLACEHOLDER), wsl_step(PLACEHOLDER), depth_step(PLACEHOLDER) {}
+};
+
+// structure for the rating of a streamnode relating wsl to the conveyance at normal depth, Q = K * sqrt(S)
+// the normal depth wsl of a flow is found by inverse interpolation of Q / sqrt(S) in the conveyance column
+struct normal_depth_rating {
+  std::vector<double> wsl;         // wsl of each rating point, increasing
+  std::vector<double> conveyance;  // effective conveyance at each rating point, made non-decreasing by taking the running maximum
+};
+
+// structure for the rows of a hydraulic_table bounding a wsl, shared by all columns interpolated at that wsl
+struct table_bracket {
+  int lower;       // index of lower bounding row
+  int upper;       // index of upper bounding row, equal to lower on an exact match
+  double new_wsl;  // wsl being interpolated to (PLACEHOLDER for depth brackets)
+  double new_depth;// depth being interpolated to (PLACEHOLDER for wsl brackets)
+};
+
 //*****************************************************************
 //Enumerables
 //*****************************************************************
@@ -269,7 +424,8 @@ enum enum_sm_method
 {
   BRENT,
   SECANT,
-  EXHAUSTIVE
+  EXHAUSTIVE,
+  NEWTON
 };
 
 // Friction slope method
@@ -345,6 +501,29 @@ enum enum_dh_method
   FLOOR
 };
 
+// Solver path taken at a streamnode, recorded in solver_telemetry
+enum enum_solver_path
+{
+  PATH_NONE,
+  PATH_BOUNDARY_CONDITION,
+  PATH_NORMAL_DEPTH,
+  PATH_ZERO_FLOW,
+  PATH_BRENT,
+  PATH_NEWTON,
+  PATH_NEWTON_TO_BRENT,
+  PATH_SECANT,
+  PATH_SECANT_TO_EXHAUSTIVE,
+  PATH_EXHAUSTIVE
+};
+
+// Acceleration of the spill flow fixed point iteration
+enum enum_sa_method
+{
+  NO_ACCELERATION,
+  AITKEN,
+  ANDERSON
+};
+
 // DHand post-processing method
 enum enum_gridded_format
 {
@@ -353,6 +532,87 @@ enum enum_gridded_format
   PNG
 };
 
+// Storage type of the cells of gridded data
+enum enum_cell_type
+{
+  CELL_FLOAT64,
+  CELL_FLOAT32,
+  CELL_INT32
+};
+
+// structure for solver telemetry of a streamnode in a flow profile, accumulated over hyd_compute_profile calls
+// declared after the enumerables as it records an enum_solver_path
+struct solver_telemetry {
+  enum_solver_path path;     // solver path taken in the most recent solve
+  int num_solves;            // number of solves accumulated, more than 1 when profiles are recomputed (e.g., spill flow iterations)
+  long residual_evals;       // number of wsl residual evaluations (including standard step iterations)
+  long energy_evals;         // number of total or specific energy evaluations, mostly in critical depth searches
+  long bracket_expansions;   // number of times a brent bracket was widened
+  long critical_fallbacks;   // number of times the solution fell back to critical depth
+  double wall_time;          // wall time (s) spent in compute_streamnode
+
+  // Constructor
+  solver_telemetry()
+      : path(PATH_NONE), num_solves(0), residual_evals(0), energy_evals(0),
+        bracket_expansions(0), critical_fallbacks(0), wall_time(0.0) {}
+};
+
+// structure for the bounds on the flow transfer between a pair of connected streamnodes in a spill flow iteration
+struct spill_transfer {
+  int ind1;           // index in bbsn of streamnode 1 (donor if the transfer is positive)
+  int ind2;           // index in bbsn of streamnode 2 (receiver if the transfer is positive)
+  double Q1;          // flow at streamnode 1
+  double Q2;          // flow at streamnode 2
+  double minQ1;       // minimum flow to maintain at streamnode 1
+  double minQ2;       // minimum flow to maintain at streamnode 2
+  double maxChange1;  // maximum change in flow at streamnode 1
+  double maxChange2;  // maximum change in flow at streamnode 2
+  int transfer;       // allowed direction of transfer, 1 -> only from 1 to 2, -1 -> only from 2 to 1, 0 -> either
+};
+
+// structure for snconntbl compiled into segments of consecutive rows with the same adjacent streamnode and reach,
+// in compressed sparse row form. each segment is a pair of connected streamnodes exchanging a single flow transfer
+struct spill_connection_graph {
+  std::vector<int> seg_start;       // position of the first row of each segment, followed by the number of rows. segment s spans rows [seg_start[s], seg_start[s+1])
+  std::vector<int> seg_ind1;        // index in bbsn of streamnode 1 of each segment, that of the last row of the segment
+  std::vector<int> seg_ind2;        // index in bbsn of streamnode 2 (adjacent streamnode) of each segment
+  std::vector<int> seg_transfer;    // allowed direction of transfer of each segment, from the last row of the segment
+  std::vector<int> row_ind1;        // index in bbsn of streamnode 1 of each row
+  std::vector<double> row_minhand1; // minimum hand of streamnode 1 along the connection of each row
+  std::vector<double> row_minhand2; // minimum hand of streamnode 2 along the connection of each row
+  std::vector<double> row_minelev1; // minimum elevation of streamnode 1 along the connection of each row
+  std::vector<double> row_minelev2; // minimum elevation of streamnode 2 along the connection of each row
+
+  int num_segments() const { return seg_start.empty() ? 0 : (int)seg_start.size() - 1; }
+};
+
+// structure for the dhand layers and interpolation weights for the depth of a catchment, shared by all of its cells
+struct dhand_bracket {
+  int lower;        // index in dhand of the first layer, -1 if none
+  int upper;        // index in dhand of the layer blended with the first, -1 if the first layer is used alone
+  double w_lower;   // weight of the first layer when blended
+  double w_upper;   // weight of the blended layer
+
+  // Constructor
+  dhand_bracket() : lower(-1), upper(-1), w_lower(1.0), w_upper(0.0) {}
+};
+
+// structure for the state of the accelerated fixed point iteration on the spill flow transfers of a flow profile
+// the iterate is the vector of transfers of the segments of the compiled spill connection graph
+struct spill_acceleration {
+  std::vector<double> x;                 // transfers applied in the current iteration
+  std::vector<double> x_prev;            // transfers applied in the previous iteration
+  std::vector<double> r_prev;            // residual G(x) - x of the previous iteration
+  std::deque<std::vector<double>> dx;    // differences of consecutive iterates kept by anderson acceleration, oldest first
+  std::deque<std::vector<double>> dr;    // differences of consecutive residuals kept by anderson acceleration, oldest first
+  double omega;                          // relaxation factor of the last aitken step
+  double residual_norm;                  // l2 norm of the residual of the last iteration
+  double residual_max;                   // largest absolute residual of the last iteration
+
+  // Constructor
+  spill_acceleration() : omega(1.0), residual_norm(0.0), residual_max(0.0) {}
+};
+
 //*****************************************************************
 //Common Functions (inline)
 //*****************************************************************
@@ -503,6 +763,295 @@ inline double interpolate(double new_wsl, double hydraulic_output::* f, std::vec
   return y2 + slope * (new_wsl - x2);
 }
 
+///////////////////////////////////////////////////////////////////
+/// \brief returns the rows of a hydraulic_table bounding new_wsl using a single binary search,
+/// or a direct index computation if the rows are uniformly spaced
+/// \note a new_wsl outside of the table range returns the last 2 rows, consistent with extrapolate()
+/// \return bracket to be passed to interpolate() for each column required
+//
+inline table_bracket find_table_bracket(double new_wsl, hydraulic_table const& t) {
+  ExitGracefullyIf(t.wsl.size() == 0,
+                   "BlackbirdInclude.h: find_table_bracket: provided table is of size 0",
+                   exitcode::RUNTIME_ERR);
+  table_bracket b;
+  b.new_wsl = new_wsl;
+  b.new_depth = PLACEHOLDER;
+  int n = (int)t.wsl.size();
+  if (new_wsl < t.wsl_min || new_wsl > t.wsl_max) {
+    ExitGracefullyIf(n < 2,
+                     "BlackbirdInclude.h: find_table_bracket: at least 2 rows are required to extrapolate",
+                     exitcode::RUNTIME_ERR);
+    b.lower = n - 2;
+    b.upper = n - 1;
+    return b;
+  }
+  int i;
+  if (t.wsl_step != PLACEHOLDER) {
+    // uniform rows, index computed directly and corrected for round-off
+    i = std::min(std::max((int)((new_wsl - t.wsl_min) / t.wsl_step), 0), n - 1);
+    while (i > 0 && t.wsl[i] > new_wsl) { i--; }
+    while (i < n - 1 && t.wsl[i + 1] <= new_wsl) { i++; }
+    i++;
+  } else {
+    i = (int)(std::upper_bound(t.wsl.begin(), t.wsl.end(), new_wsl) - t.wsl.begin());
+  }
+  b.lower = i - 1;
+  b.upper = t.wsl[i - 1] == new_wsl ? i - 1 : i;
+  return b;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief returns the rows of a hydraulic_table bounding new_depth, clamped to the first and last rows
+/// \note uses a direct index computation if the rows are uniformly spaced, otherwise a binary search
+/// \return bracket to be passed to interpolate_depth() for each column required
+//
+inline table_bracket find_table_bracket_depth(double new_depth, hydraulic_table const& t) {
+  ExitGracefullyIf(t.depth.size() == 0,
+                   "BlackbirdInclude.h: find_table_bracket_depth: provided table is of size 0",
+                   exitcode::RUNTIME_ERR);
+  table_bracket b;
+  b.new_wsl = PLACEHOLDER;
+  b.new_depth = new_depth;
+  int n = (int)t.depth.size();
+  if (new_depth <= t.depth.front()) {
+    b.lower = b.upper = 0;
+    return b;
+  }
+  if (new_depth >= t.depth.back()) {
+    b.lower = b.upper = n - 1;
+    return b;
+  }
+  int i;
+  if (t.depth_step != PLACEHOLDER) {
+    // uniform rows, index computed directly and corrected for round-off
+    i = std::min(std::max((int)((new_depth - t.depth.front()) / t.depth_step), 0), n - 2);
+    while (i > 0 && t.depth[i] > new_depth) { i--; }
+    while (i < n - 2 && t.depth[i + 1] <= new_depth) { i++; }
+  } else {
+    i = (int)(std::upper_bound(t.depth.begin(), t.depth.end(), new_depth) - t.depth.begin()) - 1;
+  }
+  b.lower = i;
+  b.upper = i + 1;
+  return b;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief returns interpolated (or extrapolated) value for the f column of hydraulic_table within bracket b
+/// \return value of the f column at the wsl of bracket b
+//
+inline double interpolate(table_bracket const& b, std::vector<double> hydraulic_table::* f, hydraulic_table const& t) {
+  std::vector<double> const& y = t.*f;
+  if (b.lower == b.upper) {
+    return y[b.lower];
+  }
+  double x2 = t.wsl[b.upper];
+  double x1 = t.wsl[b.lower];
+  double y2 = y[b.upper];
+  double y1 = y[b.lower];
+  if (x2 == PLACEHOLDER || x1 == PLACEHOLDER || y2 == PLACEHOLDER || y1 == PLACEHOLDER) {
+    return PLACEHOLDER;
+  }
+  double slope = (y2 - y1) / (x2 - x1);
+  return y2 + slope * (b.new_wsl - x2);
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief returns slope with respect to wsl of the f column of hydraulic_table within bracket b
+/// \note on an exact match with a row, the slope of the segment above the row is used (below for the last row)
+/// \return derivative of interpolate(b, f, t) with respect to the wsl of bracket b
+//
+inline double interpolate_slope(table_bracket const& b, std::vector<double> hydraulic_table::* f, hydraulic_table const& t) {
+  std::vector<double> const& y = t.*f;
+  int lower = b.lower, upper = b.upper;
+  if (lower == upper) {
+    if (upper + 1 < (int)y.size()) {
+      upper++;
+    } else if (lower > 0) {
+      lower--;
+    } else {
+      return 0.0;
+    }
+  }
+  double x2 = t.wsl[upper];
+  double x1 = t.wsl[lower];
+  double y2 = y[upper];
+  double y1 = y[lower];
+  if (x2 == PLACEHOLDER || x1 == PLACEHOLDER || y2 == PLACEHOLDER || y1 == PLACEHOLDER || x2 == x1) {
+    return 0.0;
+  }
+  return (y2 - y1) / (x2 - x1);
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief returns value for the f column of hydraulic_table linearly interpolated by depth within bracket b
+/// \return value of the f column at the depth of bracket b
+//
+inline double interpolate_depth(table_bracket const& b, std::vector<double> hydraulic_table::* f, hydraulic_table const& t) {
+  std::vector<double> const& y = t.*f;
+  if (b.lower == b.upper) {
+    return y[b.lower];
+  }
+  double d1 = t.depth[b.lower];
+  double d2 = t.depth[b.upper];
+  double w = (b.new_depth - d1) / (d2 - d1);
+  return y[b.lower] + w * (y[b.upper] - y[b.lower]);
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief less-than comparison in which NaN is never less than, and always greater than, any other value
+/// \note used for min-reductions that should skip NaN values, equivalent to the comparator previously passed to std::min_element
+//
+inline bool nan_less(double a, double b) {
+  if (std::isnan(a)) return false;
+  if (std::isnan(b)) return true;
+  return a < b;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief returns number of worker threads to use for num_threads requested and n tasks
+/// \param num_threads [in] requested number of threads, <= 0 -> all available hardware threads
+/// \param n [in] number of independent tasks
+/// \return number of worker threads, at least 1 and at most n
+//
+inline int resolve_num_threads(int num_threads, int n) {
+  if (num_threads <= 0) {
+    num_threads = std::max((int)std::thread::hardware_concurrency(), 1);
+  }
+  return std::max(std::min(num_threads, n), 1);
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief calls f(i) for each i in [0, n) across num_threads worker threads
+/// \note tasks are handed out dynamically so uneven task costs are balanced. f must only write
+/// to state owned by task i. With a single thread f is called in order on the calling thread
+/// \param n [in] number of independent tasks
+/// \param num_threads [in] requested number of threads, <= 0 -> all available hardware threads
+/// \param f [in] task function taking the task index
+//
+template<typename F>
+inline void parallel_for(int n, int num_threads, F f) {
+  int nt = resolve_num_threads(num_threads, n);
+  if (nt == 1) {
+    for (int i = 0; i < n; i++) {
+      f(i);
+    }
+    return;
+  }
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for (int i = next++; i < n; i = next++) {
+      f(i);
+    }
+  };
+  std::vector<std::thread> pool;
+  pool.reserve(nt - 1);
+  for (int t = 1; t < nt; t++) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto &th : pool) {
+    th.join();
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief runs f on each root task and on every task spawned from within f, across num_threads worker threads
+/// \note each worker keeps its own deque of tasks, taking the newest task from its own deque and
+/// stealing the oldest task from another worker's deque when its own is empty. Workers finding no task
+/// block until a task is spawned or all tasks are finished, rather than spin. With a single thread
+/// the root tasks are run in order on the calling thread and spawned tasks are run depth-first
+/// \param roots [in] initial tasks
+/// \param num_threads [in] requested number of threads, <= 0 -> all available hardware threads
+/// \param f [in] task function called as f(task, spawn), where spawn(task) schedules a new task
+//
+template<typename T, typename F>
+inline void parallel_tasks(std::vector<T> const& roots, int num_threads, F f) {
+  int nt = resolve_num_threads(num_threads, std::numeric_limits<int>::max());
+  if (nt == 1) {
+    std::vector<T> stack;
+    std::function<void(T const&)> spawn = [&](T const& t) { stack.push_back(t); };
+    for (T const& root : roots) {
+      stack.push_back(root);
+      while (!stack.empty()) {
+        T t = stack.back();
+        stack.pop_back();
+        f(t, spawn);
+      }
+    }
+    return;
+  }
+
+  struct task_deque {
+    std::mutex m;
+    std::deque<T> q;
+  };
+  std::vector<task_deque> deques(nt);
+  std::atomic<int> pending((int)roots.size()); // tasks spawned but not yet finished
+  std::atomic<int> queued((int)roots.size());  // tasks in the deques, not yet taken by a worker
+  std::mutex idle_m;                           // guards idle workers waiting on idle_cv
+  std::condition_variable idle_cv;             // notified when a task is spawned or all tasks are finished
+  for (std::size_t i = 0; i < roots.size(); i++) {
+    deques[i % nt].q.push_back(roots[i]);
+  }
+
+  auto worker = [&](int w) {
+    std::function<void(T const&)> spawn = [&](T const& t) {
+      pending++;
+      {
+        std::lock_guard<std::mutex> lock(deques[w].m);
+        deques[w].q.push_back(t);
+        queued++;
+      }
+      { // taking idle_m orders the notify after a waiter's check of queued
+        std::lock_guard<std::mutex> lock(idle_m);
+      }
+      idle_cv.notify_one();
+    };
+    while (pending > 0) {
+      T t;
+      bool found = false;
+      {
+        std::lock_guard<std::mutex> lock(deques[w].m);
+        if (!deques[w].q.empty()) {
+          t = deques[w].q.back();
+          deques[w].q.pop_back();
+          queued--;
+          found = true;
+        }
+      }
+      for (int k = 1; k < nt && !found; k++) {
+        task_deque &victim = deques[(w + k) % nt];
+        std::lock_guard<std::mutex> lock(victim.m);
+        if (!victim.q.empty()) {
+          t = victim.q.front();
+          victim.q.pop_front();
+          queued--;
+          found = true;
+        }
+      }
+      if (found) {
+        f(t, spawn);
+        if (--pending == 0) {
+          std::lock_guard<std::mutex> lock(idle_m);
+          idle_cv.notify_all();
+        }
+      } else {
+        std::unique_lock<std::mutex> lock(idle_m);
+        idle_cv.wait(lock, [&]() { return queued > 0 || pending == 0; });
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  pool.reserve(nt - 1);
+  for (int t = 1; t < nt; t++) {
+    pool.emplace_back(worker, t);
+  }
+  worker(0);
+  for (auto &th : pool) {
+    th.join();
+  }
+}
+
 ///////////////////////////////////////////////////////////////////
 /// \brief returns data type in NetCDF form given GDAL form
 /// \param gdal_type [in] data type in GDAL form
@@ -574,6 +1123,8 @@ inline std::string toString(enum_sm_method method) {
   switch (method) {
   case BRENT: return "BRENT";
   case SECANT: return "SECANT";
+  case EXHAUSTIVE: return "EXHAUSTIVE";
+  case NEWTON: return "NEWTON";
   default: return "UNKNOWN";
   }
 }
@@ -659,6 +1210,31 @@ inline std::string toString(enum_dh_method method) {
   }
 }
 
+inline std::string toString(enum_solver_path path) {
+  switch (path) {
+  case PATH_NONE: return "NONE";
+  case PATH_BOUNDARY_CONDITION: return "BOUNDARY_CONDITION";
+  case PATH_NORMAL_DEPTH: return "NORMAL_DEPTH";
+  case PATH_ZERO_FLOW: return "ZERO_FLOW";
+  case PATH_BRENT: return "BRENT";
+  case PATH_NEWTON: return "NEWTON";
+  case PATH_NEWTON_TO_BRENT: return "NEWTON_TO_BRENT";
+  case PATH_SECANT: return "SECANT";
+  case PATH_SECANT_TO_EXHAUSTIVE: return "SECANT_TO_EXHAUSTIVE";
+  case PATH_EXHAUSTIVE: return "EXHAUSTIVE";
+  default: return "UNKNOWN";
+  }
+}
+
+inline std::string toString(enum_sa_method method) {
+  switch (method) {
+  case NO_ACCELERATION: return "NONE";
+  case AITKEN: return "AITKEN";
+  case ANDERSON: return "ANDERSON";
+  default: return "UNKNOWN";
+  }
+}
+
 inline std::string toString(enum_gridded_format method) {
   switch (method) {
   case RASTER: return "RASTER";
@@ -668,6 +1244,15 @@ inline std::string toString(enum_gridded_format method) {
   }
 }
 
+inline std::string toString(enum_cell_type type) {
+  switch (type) {
+  case CELL_FLOAT64: return "FLOAT64";
+  case CELL_FLOAT32: return "FLOAT32";
+  case CELL_INT32: return "INT32";
+  default: return "UNKNOWN";
+  }
+}
+
 ///////////////////////////////////////////////////////////////////
 /// \brief converts any input to string
 /// \param t [in] thing to be converted to a string
@@ -995,4 +1580,4 @@ inline double brent_root(double a, double b,
 #define GetCurrentDir getcwd
 #endif
 
-#endif
\ No newline at end of file
+#endif
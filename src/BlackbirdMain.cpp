@@ -139,68 +139,37 @@ int main(int argc, char* argv[])
 
   t1 = clock();
   
-  // Compute hydraulic profile for all streamnodes
-  pModel->hyd_compute_profile();
+  if (pOptions->ensemble_mode) {
+    // Compute all ensemble members in batches, keeping only their aggregate results
+    pModel->compute_ensemble();
+    pModel->write_ensemble_statistics();
+  } else {
+    // Compute hydraulic profile for all streamnodes
+    pModel->hyd_compute_profile();
 
-  // if spill flows, iterate on computing profiles and computing flows
-  if (pOptions->enable_spill_flows) {
+    // if spill flows, iterate on computing profiles and computing flows
+    if (pOptions->enable_spill_flows) {
 
-      // xxx add warning here for spill mult
-      // ExitGracefullyIf(flow_mult != 1, "Spill flow calculations are not compatabile with a global flow multiplier",BAD_DATA);
+        // xxx add warning here for spill mult
+        // ExitGracefullyIf(flow_mult != 1, "Spill flow calculations are not compatabile with a global flow multiplier",BAD_DATA);
 
-      double spilldepth = -99;
-      // double minspilliterations = 5.0;
-      double spilldepthprev = -99;
+        std::cout << "Initiating Spill Flow Calculations..." << std::endl;
 
-      std::cout << "Initiating Spill Flow Calculations..." << std::endl;
+        // iterate on spill flows of each flow profile until converged
+        pModel->compute_spill_flows();
 
-      if (pModel->fp_names.size() > 1) {
-        ExitGracefully("Unable to run spill flows for multiple flow profiles "
-                       "at this time, spill flows will not be compited.",
-                       BAD_DATA);
-      }
-
-      int kk = 0; // counter for spillflows iterations
-
-      while (kk <= pOptions->iteration_limit_spillflows) {
-
-          if (!pOptions->silent_run) {
-            std::cout << "Spill Flow Iteration " << std::to_string(kk+1) << " === " << std::endl;
-          }
-
-          // zero sources before computing spill flows
-          pModel->zero_flow_sources();
-
-          // compute spill flows for each node in snconntable and update flows
-          spilldepth = pModel->update_spill_flows();
-
-          // recalculate flows
-          pModel->calc_output_flows();
-
-          // re-run hyd_compute_profile
-          pModel->hyd_compute_profile();
+        WriteAdvisory("Spill flow calculations complete!", pOptions->noisy_run);
+    }
 
-          if ( (spilldepth < pOptions->tolerance_spillflows) || spilldepth==0.0 || (kk>1 && std::abs(spilldepth-spilldepthprev)<pOptions->spilldepthchangetol)) {
-            WriteAdvisory("Spill flow calculations converged after " + std::to_string(kk + 1) +
-                              " iterations with a spilldepth of " + std::to_string(spilldepth) + 
-                              " and a change in spilldepth of " + std::to_string(std::abs(spilldepth-spilldepthprev)),
-                          pOptions->noisy_run || pOptions->debug_run);
-              break;      
-          } else {
-            kk = kk+1;
-            spilldepthprev = spilldepth;
-          }
-      }
-      if (kk >= pOptions->iteration_limit_spillflows) {
-       WriteWarning("Spill flow calculations exiting after max number of iterations and a spilldpeth of " + std::to_string(spilldepth),
-                          pOptions->noisy_run);
-      }
-      WriteAdvisory("Spill flow calculations complete!", pOptions->noisy_run);
+    // Write hydraulic results to csv file for all streamnodes (if applicable)
+    if (pOptions->write_hydraulic_output) {
+        pModel->hyd_result_pretty_print_csv(); // writes hydraulic result to csv
+    }
   }
 
-  // Write hydraulic results to csv file for all streamnodes (if applicable)
-  if (pOptions->write_hydraulic_output) {
-      pModel->hyd_result_pretty_print_csv(); // writes hydraulic result to csv
+  // Write solver telemetry for all streamnodes (if applicable)
+  if (pOptions->write_solver_telemetry) {
+      pModel->write_solver_telemetry(); // writes solver telemetry to csv
   }
 
   t2 = clock();
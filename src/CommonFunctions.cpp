@@ -1,6 +1,9 @@
 #include <time.h>
+#include <mutex>
 #include "BlackbirdInclude.h"
 
+static std::mutex g_warnings_mutex; ///< serializes writes to Blackbird_errors.txt from concurrent flow profile computations
+
 //////////////////////////////////////////////////////////////////
 /// \brief Converts any lowercase characters in a string to uppercase, returning the converted string
 /// \param &s [in] String to be converted to uppercase
@@ -125,6 +128,7 @@ bool IsComment(const char* s, const int Len)
 void WriteWarning(const std::string warn, bool noisy)
 {
   if (!g_suppress_warnings) {
+    std::lock_guard<std::mutex> lock(g_warnings_mutex);
     std::ofstream WARNINGS;
     WARNINGS.open((g_output_directory + "Blackbird_errors.txt").c_str(), std::ios::app);
     if (noisy) { std::cout << "WARNING!: " << warn << std::endl; }
@@ -141,6 +145,7 @@ void WriteWarning(const std::string warn, bool noisy)
 void WriteAdvisory(const std::string warn, bool noisy)
 {
   if (!g_suppress_warnings) {
+    std::lock_guard<std::mutex> lock(g_warnings_mutex);
     std::ofstream WARNINGS;
     WARNINGS.open((g_output_directory + "Blackbird_errors.txt").c_str(), std::ios::app);
     if (noisy) { std::cout << "ADVISORY: " << warn << std::endl; }
@@ -6,6 +6,7 @@ CGriddedData::CGriddedData()
   : name(PLACEHOLDER_STR),
   fp_name(PLACEHOLDER_STR),
   data(nullptr),
+  cell_type(CELL_FLOAT64),
   xsize(PLACEHOLDER),
   ysize(PLACEHOLDER),
   na_val(PLACEHOLDER){
@@ -15,11 +16,15 @@ CGriddedData::CGriddedData()
 CGriddedData::CGriddedData(const CGriddedData &other)
   : name(other.name),
   fp_name(other.fp_name),
-  data(static_cast<double *>(CPLMalloc(sizeof(double) * other.xsize * other.ysize))),
+  data(nullptr),
+  cell_type(other.cell_type),
   xsize(other.xsize),
   ysize(other.ysize),
   na_val(other.na_val){
-  std::copy(other.data, other.data + other.xsize * other.ysize, data);
+  if (other.data) { // streamed rasters may not hold any data
+    allocate_data();
+    memcpy(data, other.data, cell_bytes() * xsize * ysize);
+  }
 }
 
 // Copy assignment operator
@@ -29,37 +34,107 @@ CGriddedData &CGriddedData::operator=(const CGriddedData &other) {
 
   if (data) {
     CPLFree(data);
+    data = nullptr;
   }
 
   name = other.name;
   fp_name = other.fp_name;
+  cell_type = other.cell_type;
   xsize = other.xsize;
   ysize = other.ysize;
   na_val = other.na_val;
 
-  data = static_cast<double *>(CPLMalloc(sizeof(double) * xsize * ysize));
-  std::copy(other.data, other.data + xsize * ysize, data);
+  if (other.data) { // streamed rasters may not hold any data
+    allocate_data();
+    memcpy(data, other.data, cell_bytes() * xsize * ysize);
+  }
 
   return *this;
 }
 
 
 //////////////////////////////////////////////////////////////////
-/// \brief Transposes the x and y dimension of the gridded data
+/// \brief Returns the x and y dimension of "cells" transposed in a newly allocated array
+/// \param cells [in] array of xsize * ysize cells
+/// \param xsize [in] x dimension of cells
+/// \param ysize [in] y dimension of cells
 //
-void CGriddedData::transpose_data() {
-  double *transposed_data = static_cast<double *>(CPLMalloc(sizeof(double) * xsize * ysize));
+template <typename T> static T *transposed_cells(const T *cells, int xsize, int ysize) {
+  T *transposed = static_cast<T *>(CPLMalloc(sizeof(T) * xsize * ysize));
 
   for (size_t i = 0; i < ysize; ++i) {
     for (size_t j = 0; j < xsize; ++j) {
-      transposed_data[j * ysize + i] = data[i * xsize + j];
+      transposed[j * ysize + i] = cells[i * xsize + j];
     }
   }
+  return transposed;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Transposes the x and y dimension of the gridded data
+//
+void CGriddedData::transpose_data() {
+  void *transposed_data;
+  switch (cell_type) {
+  case CELL_FLOAT32: transposed_data = transposed_cells(cells<float>(), xsize, ysize); break;
+  case CELL_INT32: transposed_data = transposed_cells(cells<int32_t>(), xsize, ysize); break;
+  default: transposed_data = transposed_cells(cells<double>(), xsize, ysize); break;
+  }
 
   CPLFree(data);
   data = transposed_data;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns the size in bytes of a single cell of cell_type
+//
+size_t CGriddedData::cell_bytes() const {
+  switch (cell_type) {
+  case CELL_FLOAT32: return sizeof(float);
+  case CELL_INT32: return sizeof(int32_t);
+  default: return sizeof(double);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Allocates data to hold xsize * ysize cells of cell_type, freeing any data previously held
+/// \note the values of the cells are not initialized
+//
+void CGriddedData::allocate_data() {
+  if (data) {
+    CPLFree(data);
+  }
+  data = CPLMalloc(cell_bytes() * xsize * ysize);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Converts the gridded data to be stored as "type", converting the values of data if it is held
+/// \note int32 cells are converted to floating point exactly, and NaN cells should not be converted to int32
+/// \param type [in] storage type to convert to
+//
+void CGriddedData::set_cell_type(enum_cell_type type) {
+  if (type == cell_type) {
+    return;
+  }
+  if (!data) { // streamed rasters only read rows as the new type
+    cell_type = type;
+    return;
+  }
+  void *old_data = data;
+  enum_cell_type old_type = cell_type;
+  data = nullptr;
+  cell_type = type;
+  allocate_data();
+  for (long j = 0; j < (long)xsize * ysize; j++) {
+    switch (old_type) {
+    case CELL_FLOAT32: set_value(j, static_cast<const float *>(old_data)[j]); break;
+    case CELL_INT32: set_value(j, static_cast<const int32_t *>(old_data)[j]); break;
+    default: set_value(j, static_cast<const double *>(old_data)[j]); break;
+    }
+  }
+  CPLFree(old_data);
+}
+
 // Destructor
 CGriddedData::~CGriddedData() {
   if (data) {
@@ -8,7 +8,8 @@ public:
   // Member variables
   std::string name;                                           // name of layer
   std::string fp_name;                                        // flow profile name of layer
-  double* data;                                               // raw data values
+  void* data;                                                 // raw data values, stored as cell_type
+  enum_cell_type cell_type;                                   // storage type of data values
   int xsize;                                                  // x dimension of gridded values
   int ysize;                                                  // y dimension of gridded values
   double na_val;                                              // data value representing NA; _FillValue for NetCDF
@@ -26,6 +27,28 @@ public:
 
   // Member functions
   void transpose_data();                                      // transposes the data variable to match with expected formatting
+  size_t cell_bytes() const;                                  // size in bytes of a single cell of cell_type
+  void allocate_data();                                       // (re)allocates data to hold xsize * ysize cells of cell_type
+  void set_cell_type(enum_cell_type type);                    // converts data, if any, to be stored as type
+
+  // Cell access
+  template <typename T> T *cells() const {                    // data as an array of the type of cell_type, for kernels specialized on it
+    return static_cast<T *>(data);
+  }
+  double get_value(long j) const {                            // value of the j-th cell, for generic (non kernel) access
+    switch (cell_type) {
+    case CELL_FLOAT32: return static_cast<const float *>(data)[j];
+    case CELL_INT32: return static_cast<const int32_t *>(data)[j];
+    default: return static_cast<const double *>(data)[j];
+    }
+  }
+  void set_value(long j, double value) {                      // sets the value of the j-th cell, for generic (non kernel) access
+    switch (cell_type) {
+    case CELL_FLOAT32: static_cast<float *>(data)[j] = static_cast<float>(value); break;
+    case CELL_INT32: static_cast<int32_t *>(data)[j] = static_cast<int32_t>(value); break;
+    default: static_cast<double *>(data)[j] = value; break;
+    }
+  }
 
   // I/O Functions
   virtual void WriteToFile(std::string filepath) = 0;         // defined in StandardOutput.cpp
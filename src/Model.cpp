@@ -16,24 +16,48 @@ CModel::CModel()
   hyd_result(nullptr),
   out_gridded(),
   streamnode_map(),
-  flow(PLACEHOLDER),
-  peak_hrs_min(PLACEHOLDER),
-  peak_hrs_max(PLACEHOLDER),
+  sn_downind(),
+  sn_upind1(),
+  sn_upind2(),
+  sn_level(),
+  sn_flow_order(),
+  bc_trees(),
+  spill_conn(),
+  crit_curves(),
+  sn_telemetry(),
+  prev_net_sources(),
+  solved_down_wsl(),
+  solved_down_vhead(),
+  spill_accel(),
+  wsl_cold_solves(0),
+  wsl_cold_evals(0),
+  catch_depths(),
+  catch_num_slots(0),
+  catch_num_fp(0),
+  catch_id_min(0),
+  catch_dense(false),
   spp_depths(),
-  dhand_vals(),
-  dhandid_vals(),
+  catch_brackets(),
   flow_mult(1),
-  snconntbl(new std::vector<streamnodeconn*>) {
+  snconntbl(new std::vector<streamnodeconn*>),
+  ens_member_names(),
+  ens_nodes(),
+  ens_flows(),
+  ens_depths() {
   // Default constructor implementation
 }
 
 // Copy constructor
 CModel::CModel(const CModel &other)
-    : streamnode_map(other.streamnode_map), flow(other.flow),
-      peak_hrs_min(other.peak_hrs_min), peak_hrs_max(other.peak_hrs_max),
-      spp_depths(other.spp_depths), dhand_vals(other.dhand_vals),
-      dhandid_vals(other.dhandid_vals), flow_mult(other.flow_mult),
-      snconntbl(other.snconntbl) {
+    : streamnode_map(other.streamnode_map), sn_downind(other.sn_downind),
+      sn_upind1(other.sn_upind1), sn_upind2(other.sn_upind2), sn_level(other.sn_level), sn_flow_order(other.sn_flow_order), bc_trees(other.bc_trees), spill_conn(other.spill_conn), crit_curves(other.crit_curves),
+      sn_telemetry(other.sn_telemetry), prev_net_sources(other.prev_net_sources),
+      solved_down_wsl(other.solved_down_wsl), solved_down_vhead(other.solved_down_vhead), spill_accel(other.spill_accel),
+      wsl_cold_solves(other.wsl_cold_solves), wsl_cold_evals(other.wsl_cold_evals),
+      catch_depths(other.catch_depths), catch_num_slots(other.catch_num_slots), catch_num_fp(other.catch_num_fp), catch_id_min(other.catch_id_min), catch_dense(other.catch_dense),
+      spp_depths(other.spp_depths), catch_brackets(other.catch_brackets), flow_mult(other.flow_mult),
+      snconntbl(other.snconntbl), ens_member_names(other.ens_member_names), ens_nodes(other.ens_nodes),
+      ens_flows(other.ens_flows), ens_depths(other.ens_depths) {
   if (other.c_from_s) {
     c_from_s = other.c_from_s->clone();
   }
@@ -148,14 +172,34 @@ CModel &CModel::operator=(const CModel &other) {
 
   dhand_depth_seq = other.dhand_depth_seq;
   streamnode_map = other.streamnode_map;
-  flow = other.flow;
-  peak_hrs_min = other.peak_hrs_min;
-  peak_hrs_max = other.peak_hrs_max;
+  sn_downind = other.sn_downind;
+  sn_upind1 = other.sn_upind1;
+  sn_upind2 = other.sn_upind2;
+  sn_level = other.sn_level;
+  sn_flow_order = other.sn_flow_order;
+  bc_trees = other.bc_trees;
+  spill_conn = other.spill_conn;
+  crit_curves = other.crit_curves;
+  sn_telemetry = other.sn_telemetry;
+  prev_net_sources = other.prev_net_sources;
+  solved_down_wsl = other.solved_down_wsl;
+  solved_down_vhead = other.solved_down_vhead;
+  spill_accel = other.spill_accel;
+  wsl_cold_solves = other.wsl_cold_solves;
+  wsl_cold_evals = other.wsl_cold_evals;
+  catch_depths = other.catch_depths;
+  catch_num_slots = other.catch_num_slots;
+  catch_num_fp = other.catch_num_fp;
+  catch_id_min = other.catch_id_min;
+  catch_dense = other.catch_dense;
   spp_depths = other.spp_depths;
-  dhand_vals = other.dhand_vals;
-  dhandid_vals = other.dhandid_vals;
+  catch_brackets = other.catch_brackets;
   flow_mult = other.flow_mult;
   snconntbl = other.snconntbl;
+  ens_member_names = other.ens_member_names;
+  ens_nodes = other.ens_nodes;
+  ens_flows = other.ens_flows;
+  ens_depths = other.ens_depths;
 
   if (other.bbsn) {
     bbsn = new std::vector<CStreamnode *>();
@@ -283,8 +327,14 @@ void CModel::create_raven_profiles() {
 
 //////////////////////////////////////////////////////////////////
 /// \brief Computes the hydraulic profile for the model
+/// \note if incremental and a prior hyd_result of the same size exists, only streamnodes whose flow moved beyond
+/// bbopt->spill_resolve_flow_tol, or downstream state beyond bbopt->spill_resolve_level_tol, since they were last
+/// solved are re-solved; the prior results of all other streamnodes are kept. If fp_active is given, flow profiles that are not active keep
+/// their prior results entirely
+/// \param incremental [in] true -> re-solve only the streamnodes affected since the prior call
+/// \param fp_active [in] nonzero for each flow profile to compute, all flow profiles are computed if null
 //
-void CModel::hyd_compute_profile() {
+void CModel::hyd_compute_profile(bool incremental, const std::vector<char> *fp_active) {
   ExitGracefullyIf(bbopt->regimetype != enum_rt_method::SUBCRITICAL,
                    "Model.cpp: hyd_compute_profile(): only subcritical mode "
                    "with hardcoded options currently available",
@@ -306,79 +356,306 @@ void CModel::hyd_compute_profile() {
                    "streamnode id not represented in streamnodes",
                    BAD_DATA);
 
-  // Initialize container for hydraulic result
-  hyd_result = new std::vector<hydraulic_output *>(
-      start_streamnode->output_flows.size() * bbsn->size(), nullptr);
-
-  // Loop through each flow
-  // Compute the corresponding hydraulic profile starting at the boundary condition streamnode
-  for (int f = 0; f < start_streamnode->output_flows.size(); f++) {
-    flow = f;
-    for (auto bc : *bbbc) {
-      start_streamnode = get_streamnode_by_id(bc->nodeID);
-
-      CStreamnode **junction_sns = new CStreamnode * [bbsn->size()](); // [MAX_TREE_DEPTH], taking all sn as upper bound
-      CStreamnode *up_sn; // next upstreamnode streamnode
-      CStreamnode *curr_sn=start_streamnode; //starting streamnode (most downstream)
-
-      // compute current streamnode
-      compute_streamnode(curr_sn, curr_sn, hyd_result, bc);
-
-      // loop to compute other streamnodes moving upstream throgh branches
-      int i = 0; // index for junction_sns
-      while (curr_sn) {
-        up_sn = get_streamnode_by_id(curr_sn->upnodeID1);
-        if (up_sn)
-        {
-          // check for branching, save the current streamnode (curr_sn) if it is a junction
-          CStreamnode *branch_sn = get_streamnode_by_id(curr_sn->upnodeID2);
-          if (branch_sn) {
-            junction_sns[i] = curr_sn;
-            i++;
-          }
+  // Initialize container for hydraulic result, keeping the prior result if computing incrementally or
+  // only some of the flow profiles
+  bool keep_result = (incremental || fp_active != nullptr) && hyd_result != nullptr &&
+                     hyd_result->size() == start_streamnode->output_flows.size() * bbsn->size();
+  incremental = incremental && keep_result;
+  if (!keep_result) {
+    fp_active = nullptr;
+    hyd_result = new std::vector<hydraulic_output *>(
+        start_streamnode->output_flows.size() * bbsn->size(), nullptr);
+  }
 
-          compute_streamnode(up_sn, curr_sn, hyd_result, bc);
-          curr_sn = up_sn;
-        }  else // hit most upstream of branch, move back down to most recent junction
-        {
-          if (i > 0) {
-            if (i >= bbsn->size()) {
-              // error: too many junctions
-              ExitGracefully(
-                  "Model.cpp: hyd_compute_profile(): too many junctions in stream network",
-                             BAD_DATA);
-              break;
-            }
+  // Compute each flow profile independently, starting at the boundary condition streamnodes
+  // each profile has its own working state and writes only to its own slice of hyd_result
+  int num_fp = start_streamnode->output_flows.size();
+  std::vector<double> fp_peak_hrs_min(num_fp, PLACEHOLDER);
+  std::vector<double> fp_peak_hrs_max(num_fp, PLACEHOLDER);
+  std::atomic<long> num_warm_solves(0), warm_evals(0), num_cold_solves(0), cold_evals(0);
+  std::atomic<long> num_crit_cached(0), num_crit_exact(0), num_reused(0);
+
+  // threads are spread over profiles first; any left over are used for branches within each profile
+  int num_threads = resolve_num_threads(bbopt->num_threads, std::numeric_limits<int>::max());
+  int fp_threads = std::min(num_threads, std::max(num_fp, 1));
+  int branch_threads = std::max(num_threads / fp_threads, 1);
+
+  // downstream state each streamnode is solved against, kept with hyd_result for incremental solves
+  if (solved_down_wsl.size() != hyd_result->size()) {
+    solved_down_wsl.assign(hyd_result->size(), PLACEHOLDER);
+    solved_down_vhead.assign(hyd_result->size(), PLACEHOLDER);
+  }
 
-            i--;
-            curr_sn = junction_sns[i];            
-            up_sn = get_streamnode_by_id(curr_sn->upnodeID2);
-            compute_streamnode(up_sn, curr_sn, hyd_result, bc);
-            curr_sn = up_sn;
-          } else {
-            curr_sn = nullptr; // ran out of branches; all done
-          }
+  // telemetry accumulates over repeated calls (e.g., spill flow iterations) while the model size is unchanged
+  if (bbopt->write_solver_telemetry && sn_telemetry.size() != hyd_result->size()) {
+    sn_telemetry.assign(hyd_result->size(), solver_telemetry());
+  }
+
+  if (bbopt->modeltype == enum_mt_method::HAND_MANNING) {
+    // streamnodes are independent of each other, so all streamnode and flow profile pairs are computed at once
+    num_reused += compute_hand_manning_profiles(num_fp, num_threads, incremental, fp_active, fp_peak_hrs_min, fp_peak_hrs_max);
+  } else {
+    if (!bbopt->silent_run && num_threads > 1) {
+      std::cout << "Computing " << num_fp << " flow profiles using " << fp_threads
+                << " profile thread(s) with " << branch_threads << " branch thread(s) each" << std::endl;
+    }
+
+    parallel_for(num_fp, fp_threads, [&](int f) {
+      if (fp_active != nullptr && !(*fp_active)[f]) {
+        return;
+      }
+      profile_workspace ws(f, bbsn->size());
+      if (incremental) {
+        ws.moved.assign(bbsn->size(), 0);
+      }
+      if (bbopt->warm_start_wsl) {
+        // prior is only the solution of this profile from a previous call (e.g., spill flow iterations), so the
+        // brackets, and the root found, do not depend on the order or number of threads profiles are computed with
+        ws.prior_wsl.assign(bbsn->size(), PLACEHOLDER);
+        for (int i = 0; i < bbsn->size(); i++) {
+          ws.prior_wsl[i] = (*bbsn)[i]->output_wsls[f];
         }
       }
+      compute_flow_profile(ws, branch_threads);
+      fp_peak_hrs_min[f] = ws.peak_hrs_min;
+      fp_peak_hrs_max[f] = ws.peak_hrs_max;
+      num_warm_solves += ws.num_warm_solves;
+      warm_evals += ws.warm_evals;
+      num_cold_solves += ws.num_cold_solves;
+      cold_evals += ws.cold_evals;
+      num_crit_cached += ws.num_crit_cached;
+      num_crit_exact += ws.num_crit_exact;
+      num_reused += ws.num_reused;
+    });
+  }
+
+  if (incremental && !bbopt->silent_run) {
+    std::cout << "Kept prior results of " << num_reused << " streamnode and flow profile pairs, re-solving the rest"
+              << std::endl;
+  }
+
+  wsl_cold_solves += num_cold_solves;
+  wsl_cold_evals += cold_evals;
+  if (bbopt->warm_start_wsl && num_warm_solves > 0) {
+    // savings are estimated against the average cost of cold started solves seen so far
+    std::string msg = "Warm started " + std::to_string(num_warm_solves) + " of " +
+                      std::to_string(num_warm_solves + num_cold_solves) + " WSL solves using " +
+                      std::to_string(warm_evals) + " residual evaluations";
+    if (wsl_cold_solves > 0) {
+      double cold_avg = (double)wsl_cold_evals / wsl_cold_solves;
+      double saved = cold_avg * num_warm_solves - warm_evals;
+      msg += ", an estimated " + std::to_string((long)std::round(saved)) +
+             " residual evaluations saved relative to the cold start average of " +
+             std::to_string(cold_avg) + " per solve";
+    }
+    WriteAdvisory(msg, bbopt->noisy_run);
+    if (!bbopt->silent_run) {
+      std::cout << msg << std::endl;
+    }
+  }
+
+  if (bbopt->critical_depth_cache && !bbopt->silent_run) {
+    std::cout << "Interpolated " << num_crit_cached << " of " << num_crit_cached + num_crit_exact
+              << " critical depths from cached curves, recomputing " << num_crit_exact
+              << " exactly where the cached error bound was exceeded" << std::endl;
+  }
+
+  for (int f = 0; f < num_fp; f++) {
+    if (fp_active != nullptr && !(*fp_active)[f]) {
+      continue;
     }
     WriteAdvisory("The range of required peak flood times ranges from " +
-                      std::to_string(peak_hrs_min) + " to " +
-                      std::to_string(peak_hrs_max) + " hours for flow profile " +
-                      std::to_string(flow+1) + " (" + fp_names[flow] +
+                      std::to_string(fp_peak_hrs_min[f]) + " to " +
+                      std::to_string(fp_peak_hrs_max[f]) + " hours for flow profile " +
+                      std::to_string(f+1) + " (" + fp_names[f] +
                       ") within the computed streamnodes",
                   bbopt->noisy_run);
-    peak_hrs_min = PLACEHOLDER;
-    peak_hrs_max = PLACEHOLDER;
   }
   if (!bbopt->silent_run) {
     std::cout << "Successfully completed all hydraulic calculations :-)" << std::endl;
   }
-  flow = PLACEHOLDER;
   return;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Computes the hydraulic profile of a single flow profile for all boundary conditions
+/// \note only touches ws, the ws.flow-th slice of hyd_result and the ws.flow-th entries of the
+/// streamnode output vectors, so that separate flow profiles may be computed concurrently.
+/// Each branch of the compiled boundary condition trees is a task; the upnodeID2 branch of a
+/// junction is spawned once the junction is solved, since both of its upstream branches depend
+/// only on the junction's state
+/// \param ws [in/out] working state of the flow profile to compute
+/// \param num_threads [in] number of threads used to compute branches of the profile
+//
+void CModel::compute_flow_profile(profile_workspace &ws, int num_threads) {
+  std::vector<branch_task> roots;
+  for (int t = 0; t < bc_trees.size(); t++) {
+    roots.push_back(branch_task{t, 0});
+  }
+
+  parallel_tasks(roots, num_threads,
+                 [&](branch_task const &task, std::function<void(branch_task const &)> const &spawn) {
+    compiled_tree const &tree = bc_trees[task.tree];
+    CBoundaryCondition *bc = (*bbbc)[tree.bc_ind];
+    int end = task.branch + 1 < tree.branch.size() ? tree.branch[task.branch + 1] : tree.order.size();
+
+    // compute streamnodes moving upstream through the branch, spawning branches at junctions
+    for (int p = tree.branch[task.branch]; p < end; p++) {
+      if (ws.moved.empty()) {
+        compute_streamnode(tree.order[p], tree.down[p], hyd_result, bc, ws);
+      } else {
+        compute_streamnode_incremental(tree.order[p], tree.down[p], bc, ws);
+      }
+      if (tree.spawn[p] != -1) {
+        spawn(branch_task{task.tree, tree.spawn[p]});
+      }
+    }
+  });
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Computes the hydraulic profiles of all flow profiles in HAND_MANNING mode
+/// \note in HAND_MANNING mode the depth of each streamnode is its normal depth, which does not depend on
+/// the downstream streamnode, so every streamnode and flow profile pair is an independent task. Pairs are
+/// handed out in chunks of consecutive streamnodes of one flow profile, and each worker keeps its own
+/// working state as scratch, so each pair writes only its own entries of hyd_result and the streamnode
+/// output vectors
+/// \param num_fp [in] number of flow profiles
+/// \param num_threads [in] number of worker threads
+/// \param incremental [in] true -> pairs whose flow has not moved beyond tolerance keep their prior result in hyd_result
+/// \param fp_active [in] nonzero for each flow profile to compute, all flow profiles are computed if null
+/// \param fp_peak_hrs_min [out] minimum peak hours required of each flow profile
+/// \param fp_peak_hrs_max [out] maximum peak hours required of each flow profile
+/// \return number of pairs whose prior result was kept
+//
+long CModel::compute_hand_manning_profiles(int num_fp, int num_threads, bool incremental,
+                                           const std::vector<char> *fp_active,
+                                           std::vector<double> &fp_peak_hrs_min,
+                                           std::vector<double> &fp_peak_hrs_max) {
+  static constexpr int CHUNK_SIZE = 64; // streamnodes handed out to a worker at a time
+
+  // streamnodes of all boundary condition trees, in no particular order
+  std::vector<int> node_ind, down_ind, tree_ind;
+  for (int t = 0; t < bc_trees.size(); t++) {
+    for (int p = 0; p < bc_trees[t].order.size(); p++) {
+      node_ind.push_back(bc_trees[t].order[p]);
+      down_ind.push_back(bc_trees[t].down[p]);
+      tree_ind.push_back(t);
+    }
+  }
+  long num_nodes = node_ind.size();
+  long num_chunks_fp = (num_nodes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  long num_chunks = num_chunks_fp * num_fp;
+
+  int nt = resolve_num_threads(num_threads, (int)std::min<long>(num_chunks, std::numeric_limits<int>::max()));
+  if (!bbopt->silent_run && nt > 1) {
+    std::cout << "Computing " << num_nodes * num_fp << " streamnode and flow profile pairs of "
+              << num_fp << " flow profiles using " << nt << " thread(s)" << std::endl;
+  }
+
+  std::atomic<long> next_chunk(0), num_reused(0);
+  std::mutex peak_mutex;
+  parallel_for(nt, nt, [&](int w) {
+    // scratch of this worker; each chunk resets the flow profile and peak hours before computing
+    profile_workspace ws(0, bbsn->size());
+    if (incremental) {
+      ws.moved.assign(bbsn->size(), 0);
+    }
+    std::vector<double> peak_min(num_fp, PLACEHOLDER), peak_max(num_fp, PLACEHOLDER);
+
+    for (long c = next_chunk++; c < num_chunks; c = next_chunk++) {
+      ws.flow = c / num_chunks_fp;
+      if (fp_active != nullptr && !(*fp_active)[ws.flow]) {
+        continue;
+      }
+      ws.peak_hrs_min = PLACEHOLDER;
+      ws.peak_hrs_max = PLACEHOLDER;
+      long first = (c % num_chunks_fp) * CHUNK_SIZE;
+      long last = std::min(first + CHUNK_SIZE, num_nodes);
+      for (long k = first; k < last; k++) {
+        CBoundaryCondition *bc = (*bbbc)[bc_trees[tree_ind[k]].bc_ind];
+        if (incremental) {
+          compute_streamnode_incremental(node_ind[k], down_ind[k], bc, ws);
+        } else {
+          compute_streamnode(node_ind[k], down_ind[k], hyd_result, bc, ws);
+        }
+      }
+      if (ws.peak_hrs_min != PLACEHOLDER &&
+          (peak_min[ws.flow] == PLACEHOLDER || ws.peak_hrs_min < peak_min[ws.flow])) {
+        peak_min[ws.flow] = ws.peak_hrs_min;
+      }
+      if (ws.peak_hrs_max != PLACEHOLDER &&
+          (peak_max[ws.flow] == PLACEHOLDER || ws.peak_hrs_max > peak_max[ws.flow])) {
+        peak_max[ws.flow] = ws.peak_hrs_max;
+      }
+    }
+
+    num_reused += ws.num_reused;
+    std::lock_guard<std::mutex> lock(peak_mutex);
+    for (int f = 0; f < num_fp; f++) {
+      if (peak_min[f] != PLACEHOLDER && (fp_peak_hrs_min[f] == PLACEHOLDER || peak_min[f] < fp_peak_hrs_min[f])) {
+        fp_peak_hrs_min[f] = peak_min[f];
+      }
+      if (peak_max[f] != PLACEHOLDER && (fp_peak_hrs_max[f] == PLACEHOLDER || peak_max[f] > fp_peak_hrs_max[f])) {
+        fp_peak_hrs_max[f] = peak_max[f];
+      }
+    }
+  });
+  return num_reused;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Re-solves a streamnode only if its flow or downstream state moved since it was last solved
+/// \note the prior result in hyd_result is kept, and copied into the working state, if the flow of the
+/// streamnode is within a relative bbopt->spill_resolve_flow_tol of the flow it was solved for and, outside of
+/// HAND_MANNING mode, the downstream wsl and velocity head are within bbopt->spill_resolve_level_tol (m) of those it was
+/// solved against (solved_down_wsl and solved_down_vhead). As the comparison is against the state of the last
+/// solve of this streamnode, small downstream changes over several calls accumulate until it is re-solved
+/// \param ind [in] index in bbsn of streamnode
+/// \param down_ind [in] index in bbsn of streamnode one node downstream
+/// \param bc [in] boundary condition for current set of streamnodes
+/// \param ws [in/out] working state of the flow profile being computed, with moved allocated
+//
+void CModel::compute_streamnode_incremental(int ind, int down_ind, CBoundaryCondition *&bc, profile_workspace &ws) {
+  const hydraulic_output *prior = (*hyd_result)[ws.flow * bbsn->size() + ind];
+  if (prior == nullptr) {
+    compute_streamnode(ind, down_ind, hyd_result, bc, ws);
+    ws.moved[ind] = 1;
+    return;
+  }
+
+  double flow = (*bbsn)[ind]->output_flows[ws.flow];
+  long e = (long)ws.flow * bbsn->size() + ind;
+  const hydraulic_output &down_mm = ws.mm[down_ind];
+  bool down_moved = bbopt->modeltype != enum_mt_method::HAND_MANNING && down_ind != ind &&
+                    (solved_down_wsl[e] == PLACEHOLDER ||
+                     std::abs(down_mm.wsl - solved_down_wsl[e]) > bbopt->spill_resolve_level_tol ||
+                     std::abs(down_mm.velocity_head - solved_down_vhead[e]) > bbopt->spill_resolve_level_tol);
+  if (!down_moved && std::abs(flow - prior->flow) <= bbopt->spill_resolve_flow_tol * std::abs(prior->flow)) {
+    ws.mm[ind] = *prior;
+    ws.moved[ind] = 0;
+    ws.num_reused++;
+    if (prior->peak_hrs_required > 0.0) {
+      std::lock_guard<std::mutex> peak_lock(ws.peak_hrs_mutex);
+      if (ws.peak_hrs_min == PLACEHOLDER || prior->peak_hrs_required < ws.peak_hrs_min) {
+        ws.peak_hrs_min = prior->peak_hrs_required;
+      }
+      if (ws.peak_hrs_max == PLACEHOLDER || prior->peak_hrs_required > ws.peak_hrs_max) {
+        ws.peak_hrs_max = prior->peak_hrs_required;
+      }
+    }
+    return;
+  }
+
+  compute_streamnode(ind, down_ind, hyd_result, bc, ws);
+  ws.moved[ind] = 1;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Calculate output flows of all streamnodes
+/// \note flows are accumulated in a single pass over sn_flow_order. The flows of computed streamnodes are
+/// gathered in a contiguous streamnode by flow profile matrix, from which the upstream flows of each
+/// streamnode are summed across all flow profiles
 //
 void CModel::calc_output_flows() {
     int total_nodes = bbsn->size();           // number of nodes in bbsn
@@ -386,52 +663,30 @@ void CModel::calc_output_flows() {
 
     if (bbopt->explicit_flows == false) {
         // update flows based on accumulated flows in each reach
-        std::set<int> finished_nodes;             // sorted list of nodes where output_flows has been calculated
-        std::unordered_map<int, int> id_to_ind;   // maps nodeID to index in bbsn
-
-        for (int iter = 0; finished_nodes.size() < total_nodes && iter < 1000; iter++) {
-            for (int i = 0; i < total_nodes; i++) {
-                CStreamnode*& temp_sn = (*bbsn)[i]; // reference to current streamnode pointer to simplify code
-                // If first while loop iteration, add node to id_to_ind
-                if (iter == 0) {
-                    id_to_ind[temp_sn->nodeID] = i;
-                }
-
-                // If node has been calculated, skip
-                if (finished_nodes.find(temp_sn->nodeID) != finished_nodes.end()) {
-                    continue;
-                }
-                // If either upnodes have not been calculated already, skip
-                if ((temp_sn->upnodeID1 != -1 && (finished_nodes.find(temp_sn->upnodeID1) == finished_nodes.end()))
-                    || (temp_sn->upnodeID2 != -1 && (finished_nodes.find(temp_sn->upnodeID2) == finished_nodes.end()))) {
-                    continue;
-                }
-
-                // If headwater, add to finished nodes and continue
-                if (temp_sn->upstream_flows.size() > 0 && temp_sn->upstream_flows[0] == HEADWATER) {
-                    // finished_nodes.insert(temp_sn->nodeID);
-                    // If num_fp has yet to be assigned, assign it (will execute on a headwater node in first iteration)
-                    if (num_fp == PLACEHOLDER) {
-                        num_fp = temp_sn->output_flows.size();
-                    }
-
-                    temp_sn->calc_output_flows_headwaternode(bbopt);
-                    finished_nodes.insert(temp_sn->nodeID);
-                    continue;
-                }
-
-                // Calculate total upstream flow to send into calc_output_flows function
-                std::vector<double> upflows = (*bbsn)[id_to_ind[temp_sn->upnodeID1]]->output_flows;
-                if (temp_sn->upnodeID2 != -1) {
+        num_fp = fp_names.size();
+        std::vector<double> flows(total_nodes * num_fp, 0.0); // output flows of computed streamnodes, row per streamnode
+        std::vector<double> upflows(num_fp);                  // total upstream flow to send into calc_output_flows function
+
+        for (int ind : sn_flow_order) {
+            CStreamnode*& temp_sn = (*bbsn)[ind]; // reference to current streamnode pointer to simplify code
+
+            if (temp_sn->upstream_flows.size() > 0 && temp_sn->upstream_flows[0] == HEADWATER) {
+                temp_sn->calc_output_flows_headwaternode(bbopt);
+            } else if (sn_upind1[ind] != -1) {
+                const double *up1 = flows.data() + sn_upind1[ind] * num_fp;
+                if (sn_upind2[ind] != -1) {
+                    const double *up2 = flows.data() + sn_upind2[ind] * num_fp;
                     for (int j = 0; j < num_fp; j++) {
-                        upflows[j] += (*bbsn)[id_to_ind[temp_sn->upnodeID2]]->output_flows[j];
+                        upflows[j] = up1[j] + up2[j];
                     }
+                } else {
+                    std::copy(up1, up1 + num_fp, upflows.begin());
                 }
                 temp_sn->calc_output_flows(upflows);
-
-                // add node to finished_nodes
-                finished_nodes.insert(temp_sn->nodeID);
             }
+            // a streamnode without upstream streamnodes that is not a headwater keeps its flows
+            int n = std::min<int>(temp_sn->output_flows.size(), num_fp);
+            std::copy(temp_sn->output_flows.begin(), temp_sn->output_flows.begin() + n, flows.begin() + ind * num_fp);
         }
     }
     else {
@@ -465,19 +720,99 @@ void CModel::calc_output_flows() {
         }
         std::cout << "Sum of flow_sources = " << sum_sources << std::endl;
     }
+
+    if (bbopt->incremental_spill_flows) {
+        record_net_sources();
+    }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Recalculates output flows of streamnodes whose sources or sinks changed since the last flow
+/// calculation, and of all streamnodes downstream of them
+/// \note gives the same flows as calc_output_flows. calc_output_flows_headwaternode adds the net sources of
+/// a headwater to its flow on every pass, so headwaters with any net source are recalculated as well. Falls
+/// back to calc_output_flows if flows are explicit, a global flow multiplier is used or no prior net
+/// sources were recorded
+//
+void CModel::calc_output_flows_incremental() {
+    int total_nodes = bbsn->size();
+    int num_fp = fp_names.size();
+    if (bbopt->explicit_flows || flow_mult != 1 || prev_net_sources.size() != num_fp * total_nodes) {
+        calc_output_flows();
+        return;
+    }
+
+    // mark streamnodes whose net sources changed, along with all streamnodes downstream of them
+    std::vector<char> affected(total_nodes, 0);
+    std::vector<int> recalc;
+    for (int i = 0; i < total_nodes; i++) {
+        CStreamnode *sn = (*bbsn)[i];
+        bool headwater = !sn->upstream_flows.empty() && sn->upstream_flows[0] == HEADWATER;
+        bool changed = false;
+        for (int f = 0; f < num_fp && !changed; f++) {
+            double net = sn->flow_sources[f] - sn->flow_sinks[f];
+            changed = net != prev_net_sources[f * total_nodes + i] || (headwater && net != 0.0);
+        }
+        for (int curr = i; changed && curr != -1 && !affected[curr]; curr = sn_downind[curr]) {
+            affected[curr] = 1;
+            recalc.push_back(curr);
+        }
+    }
+
+    // recalculate upstream streamnodes before those downstream of them
+    std::sort(recalc.begin(), recalc.end(), [&](int a, int b) { return sn_level[a] > sn_level[b]; });
+    for (int ind : recalc) {
+        CStreamnode *sn = (*bbsn)[ind];
+        if (!sn->upstream_flows.empty() && sn->upstream_flows[0] == HEADWATER) {
+            sn->calc_output_flows_headwaternode(bbopt);
+            continue;
+        }
+        if (sn_upind1[ind] == -1) {
+            continue;
+        }
+        std::vector<double> upflows = (*bbsn)[sn_upind1[ind]]->output_flows;
+        if (sn_upind2[ind] != -1) {
+            for (int j = 0; j < num_fp; j++) {
+                upflows[j] += (*bbsn)[sn_upind2[ind]]->output_flows[j];
+            }
+        }
+        sn->calc_output_flows(upflows);
+    }
+
+    if (!bbopt->silent_run) {
+        std::cout << "Recalculated flows of " << recalc.size() << " of " << total_nodes
+                  << " streamnodes affected by changed sources and sinks" << std::endl;
+    }
+    record_net_sources();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Stores the flow sources less sinks of all streamnodes and flow profiles in prev_net_sources
+//
+void CModel::record_net_sources() {
+    int total_nodes = bbsn->size();
+    int num_fp = fp_names.size();
+    prev_net_sources.assign(num_fp * total_nodes, 0.0);
+    for (int i = 0; i < total_nodes; i++) {
+        CStreamnode *sn = (*bbsn)[i];
+        for (int f = 0; f < num_fp && f < sn->flow_sources.size(); f++) {
+            prev_net_sources[f * total_nodes + i] = sn->flow_sources[f] - sn->flow_sinks[f];
+        }
+    }
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Sets all flow sources and sinks to zero before proceeding with spill flow calculations to update them based on spill flow calculations
+/// \brief Sets all flow sources and sinks of a flow profile to zero before proceeding with spill flow calculations to update them based on spill flow calculations
+/// \param f [in] index of flow profile
 //
-void CModel::zero_flow_sources() {
+void CModel::zero_flow_sources(int f) {
     for (int i = 0; i < bbsn->size(); i++) {
         CStreamnode*& sn = (*bbsn)[i];
-        for (double &src : sn->flow_sources) {
-            src = 0.0;
+        if (f < sn->flow_sources.size()) {
+            sn->flow_sources[f] = 0.0;
         }
-        for (double &snk : sn->flow_sinks) {
-            snk = 0.0;
+        if (f < sn->flow_sinks.size()) {
+            sn->flow_sinks[f] = 0.0;
         }
     }
 }
@@ -523,143 +858,555 @@ double clamp_transfer(double cumqtransfer,
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Update sources and sinks based on spill flow calculations
+/// \brief Bounds a spill flow transfer with clamp_transfer and the allowed direction of transfer
+/// \param cumqtransfer [in] transfer from streamnode 1 to streamnode 2 (negative if from 2 to 1)
+/// \param st [in] bounds on the transfer
+/// \return bounded transfer
 //
-double CModel::update_spill_flows() {
-    double max_deltaQ = 0.0;                  // max exchange in flow between streamnodes
-    double max_spillheightdiff = 0.0;             // max difference in spill height between streamnodes (used to compute flow transfer rate)
-    double cumqtransfer = 0.0;
+double bound_spill_transfer(double cumqtransfer, const spill_transfer &st)
+{
+    cumqtransfer = clamp_transfer(cumqtransfer,
+                                  st.Q1, st.Q2,
+                                  st.minQ1, st.minQ2,
+                                  st.maxChange1, st.maxChange2);
+    if ((st.transfer == 1 && cumqtransfer < 0) ||
+        (st.transfer == -1 && cumqtransfer > 0)) {
+        cumqtransfer = 0.0;
+    }
+    return cumqtransfer;
+}
 
-    double coeff_qi_rate = bbopt->spillflowsmaxqrate; // computes max flow rate change based on coeff_qi_rate*Q for each iteration [0..1]
-    // e.g., coeff_qi_rate = 0.9, max flow rate change is 90% of the current flow rate
+//////////////////////////////////////////////////////////////////
+/// \brief Computes the next iterate of the spill flow transfers of a flow profile from G(x), the transfers
+/// computed from the hydraulic profile of the current transfers x
+/// \note with no acceleration the next iterate is G(x). Aitken acceleration relaxes the step along the
+/// residual r = G(x) - x with the Irons-Tuck factor, and anderson acceleration takes the combination of
+/// up to depth previous steps that minimizes the linearized residual. acc is reset if the number of
+/// transfers changes. The next iterate is unbounded; it is bounded by the caller
+/// \param acc [in/out] state of the iteration, with x the transfers applied in the current iteration
+/// \param g [in] transfers G(x) computed from the hydraulic profile of x
+/// \param method [in] acceleration method
+/// \param depth [in] maximum number of previous steps used by anderson acceleration
+/// \return next iterate of the transfers
+//
+std::vector<double> accelerate_spill_transfers(spill_acceleration &acc, const std::vector<double> &g,
+                                               enum_sa_method method, int depth)
+{
+    static constexpr double OMEGA_MIN = 0.1; // bounds on the aitken relaxation factor
+    static constexpr double OMEGA_MAX = 2.0;
 
-    double coeff_min_flow = bbopt->spillflowsminq; // minimum flow to maintain in streamnodes from original, computed as coeff_min_flow*Q [0..1]
-    // e.g., coeff_min_flow = 0.1, flow will not reduce below 10% of original flow from previous solution
+    int n = g.size();
+    if (acc.x.size() != n) {
+        acc = spill_acceleration();
+        acc.x.assign(n, 0.0); // sources are zero before the first spill flow iteration
+    }
 
-    for (int i = 0; i < snconntbl->size(); i++) {
-        // get streamnode references
-        streamnodeconn* row = (*snconntbl)[i];
-        int ind1 = get_index_by_id(row->nodeID);
-        int ind2 = get_index_by_id(row->adjnodeID);
-        CStreamnode*& temp_sn1 = (*bbsn)[ind1];
-        CStreamnode*& temp_sn2 = (*bbsn)[ind2];
-        bool setqtransfer = false;
-        
-        // conditons to end qtransfer calc or not
-        if (i == snconntbl->size() - 1) {
-          setqtransfer = true; // ended due to end of file
-        } else {
-            // end if the next row has a change in the pairing of cid & adjid OR if the reachID changes
-            streamnodeconn *nextrow = (*snconntbl)[i+1];
-            int ind3 = get_index_by_id(nextrow->adjnodeID);
-            if (ind3 != ind2 || nextrow->reachID != row->reachID) { 
-              setqtransfer = true;
-            }
+    std::vector<double> r(n);
+    double rr = 0.0;
+    acc.residual_max = 0.0;
+    for (int i = 0; i < n; i++) {
+        r[i] = g[i] - acc.x[i];
+        rr += r[i] * r[i];
+        acc.residual_max = std::max(acc.residual_max, std::abs(r[i]));
+    }
+    acc.residual_norm = std::sqrt(rr);
+
+    std::vector<double> x_next = g;
+    bool has_prev = acc.r_prev.size() == n;
+    if (method == enum_sa_method::AITKEN && has_prev) {
+        double num = 0.0, denom = 0.0;
+        for (int i = 0; i < n; i++) {
+            double d = r[i] - acc.r_prev[i];
+            num += acc.r_prev[i] * d;
+            denom += d * d;
         }
-        
-      // get depths at each node from hydraulic results
-      hydraulic_output *depthrow1 = (*hyd_result)[ind1];
-      hydraulic_output *depthrow2 = (*hyd_result)[ind2];
-
-      // compute difference in transfer elevation (absolute value)
-      double spillheightdiff = (std::max(depthrow1->depth - row->minhand1,0.0)+row->minelev1) - 
-                               (std::max(depthrow2->depth - row->minhand2,0.0)+row->minelev2);    
-
-      if (std::abs(spillheightdiff) > 0) {
-        // update max spillheightdiff
-        if (std::abs(spillheightdiff) > max_spillheightdiff) {
-          max_spillheightdiff = std::abs(spillheightdiff);
+        if (denom > 0.0) {
+            acc.omega = std::min(std::max(-acc.omega * num / denom, OMEGA_MIN), OMEGA_MAX);
+        }
+        for (int i = 0; i < n; i++) {
+            x_next[i] = acc.x[i] + acc.omega * r[i];
+        }
+    } else if (method == enum_sa_method::ANDERSON && has_prev && depth > 0) {
+        std::vector<double> dx(n), dr(n);
+        for (int i = 0; i < n; i++) {
+            dx[i] = acc.x[i] - acc.x_prev[i];
+            dr[i] = r[i] - acc.r_prev[i];
+        }
+        acc.dx.push_back(dx);
+        acc.dr.push_back(dr);
+        while (acc.dx.size() > depth) {
+            acc.dx.pop_front();
+            acc.dr.pop_front();
         }
-      }
-      
-      double qtransfer = spillheightdiff * bbopt->kspillflows;
-      cumqtransfer = cumqtransfer + qtransfer;
-
-      if (setqtransfer) {
 
-        // limit qtransfer based on receiving body's flow rate, avoid a 50% increase in flows
-        /* if (cumqtransfer > 0) {
-          if (cumqtransfer > depthrow2->flow*coeff_qi_rate) {
-            cumqtransfer = depthrow2->flow * coeff_qi_rate;
-          }
+        // least squares for gamma minimizing |r - dR gamma|, from the regularized normal equations
+        int m = acc.dr.size();
+        std::vector<std::vector<double>> A(m, std::vector<double>(m + 1, 0.0));
+        double trace = 0.0;
+        for (int a = 0; a < m; a++) {
+            for (int b = 0; b <= a; b++) {
+                double v = 0.0;
+                for (int i = 0; i < n; i++) {
+                    v += acc.dr[a][i] * acc.dr[b][i];
+                }
+                A[a][b] = A[b][a] = v;
+            }
+            for (int i = 0; i < n; i++) {
+                A[a][m] += acc.dr[a][i] * r[i];
+            }
+            trace += A[a][a];
+        }
+        bool solved = trace > 0.0;
+        for (int a = 0; a < m && solved; a++) {
+            A[a][a] += 1e-10 * trace;
+        }
+        // gaussian elimination with partial pivoting
+        for (int c = 0; c < m && solved; c++) {
+            int piv = c;
+            for (int a = c + 1; a < m; a++) {
+                if (std::abs(A[a][c]) > std::abs(A[piv][c])) {
+                    piv = a;
+                }
+            }
+            std::swap(A[c], A[piv]);
+            if (A[c][c] == 0.0) {
+                solved = false;
+                break;
+            }
+            for (int a = c + 1; a < m; a++) {
+                double factor = A[a][c] / A[c][c];
+                for (int b = c; b <= m; b++) {
+                    A[a][b] -= factor * A[c][b];
+                }
+            }
+        }
+        if (solved) {
+            std::vector<double> gamma(m);
+            for (int a = m - 1; a >= 0; a--) {
+                double v = A[a][m];
+                for (int b = a + 1; b < m; b++) {
+                    v -= A[a][b] * gamma[b];
+                }
+                gamma[a] = v / A[a][a];
+            }
+            for (int i = 0; i < n; i++) {
+                double corr = 0.0;
+                for (int a = 0; a < m; a++) {
+                    corr += gamma[a] * (acc.dx[a][i] + acc.dr[a][i]);
+                }
+                x_next[i] = acc.x[i] + r[i] - corr;
+            }
         } else {
-          if (abs(cumqtransfer) > depthrow1->flow * coeff_qi_rate) {
-            cumqtransfer = depthrow1->flow * (-coeff_qi_rate);
-          }
+            acc.dx.clear();
+            acc.dr.clear();
         }
-        */
-
+    }
 
-        // clamp the transfer rate with bounds
-        double Q1 = temp_sn1->output_flows[0];
-        double Q2 = temp_sn2->output_flows[0];
+    acc.x_prev = acc.x;
+    acc.r_prev = r;
+    return x_next;
+}
 
-        double minQ1 = depthrow1->flow * coeff_min_flow;
-        double minQ2 = depthrow2->flow * coeff_min_flow;
+//////////////////////////////////////////////////////////////////
+/// \brief Update sources and sinks of a flow profile based on spill flow calculations
+/// \note only reads and writes the f-th entries of hyd_result and the streamnode flow vectors, so that
+/// separate flow profiles may be updated concurrently. The transfer of each segment of spill_conn is
+/// reduced over its rows in parallel, and the transfers are then applied to the sources in segment order
+/// so that the result does not depend on the number of threads
+/// \param f [in] index of flow profile
+/// \param num_threads [in] number of threads used to compute the transfers of the segments
+/// \return max spill height difference between connected streamnodes
+//
+double CModel::update_spill_flows(int f, int num_threads) {
+    static constexpr int CHUNK_SIZE = 1024; // segments handed out to a worker at a time
 
-        double maxChange1 = Q1 * coeff_qi_rate;
-        double maxChange2 = Q2 * coeff_qi_rate;
+    double coeff_qi_rate = bbopt->spillflowsmaxqrate; // computes max flow rate change based on coeff_qi_rate*Q for each iteration [0..1]
+    // e.g., coeff_qi_rate = 0.9, max flow rate change is 90% of the current flow rate
 
-        cumqtransfer = clamp_transfer(cumqtransfer,
-                                      Q1, Q2,
-                                      minQ1, minQ2,
-                                      maxChange1, maxChange2);
-
-        // update cumqtransfer if limited by transfer integer
-        // if transfer is:
-        // 1, means sn1
-        if ((row->transfer == 1 && cumqtransfer < 0) ||
-            (row->transfer == -1 && cumqtransfer > 0)) {
-          cumqtransfer = 0.0; // set to zero to prevent transfer of flow from DS
-                              // -> US node. US -> DS is ok
-
-          if (bbopt->debug_run) {
-            std::cout << "setting cumqtransfer to zero for nodes "
-            << std::to_string(temp_sn1->nodeID) << " -> "
-            << std::to_string(temp_sn2->nodeID) << std::endl;
-          }
+    double coeff_min_flow = bbopt->spillflowsminq; // minimum flow to maintain in streamnodes from original, computed as coeff_min_flow*Q [0..1]
+    // e.g., coeff_min_flow = 0.1, flow will not reduce below 10% of original flow from previous solution
 
+    int total_nodes = bbsn->size();
+    int num_segments = spill_conn.num_segments();
+    int num_chunks = (num_segments + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<spill_transfer> transfers(num_segments);
+    std::vector<double> g(num_segments, 0.0);      // bounded transfer of each segment
+    std::vector<char> blocked(num_segments, 0);    // 1 if the transfer of a segment was zeroed by its allowed direction
+    std::vector<double> chunk_max(num_chunks, 0.0); // max spill height difference of each chunk of segments
+
+    parallel_for(num_chunks, num_threads, [&](int c) {
+      int first = c * CHUNK_SIZE;
+      int last = std::min(first + CHUNK_SIZE, num_segments);
+      for (int s = first; s < last; s++) {
+        int ind1 = spill_conn.seg_ind1[s];
+        int ind2 = spill_conn.seg_ind2[s];
+        double depth2 = (*hyd_result)[f * total_nodes + ind2]->depth;
+
+        // sum transfers over the rows of the segment from the differences in transfer elevation
+        double cumqtransfer = 0.0;
+        for (int k = spill_conn.seg_start[s]; k < spill_conn.seg_start[s + 1]; k++) {
+          double depth1 = (*hyd_result)[f * total_nodes + spill_conn.row_ind1[k]]->depth;
+          double spillheightdiff = (std::max(depth1 - spill_conn.row_minhand1[k], 0.0) + spill_conn.row_minelev1[k]) -
+                                   (std::max(depth2 - spill_conn.row_minhand2[k], 0.0) + spill_conn.row_minelev2[k]);
+          chunk_max[c] = std::max(chunk_max[c], std::abs(spillheightdiff));
+          cumqtransfer = cumqtransfer + spillheightdiff * bbopt->kspillflows;
         }
-        
-        // update flow sources
-        temp_sn1->flow_sources[0] += cumqtransfer*(-1);
-        temp_sn2->flow_sources[0] += cumqtransfer;
-        
-        // recalculate all flows based on updated sources and sinks to ensure 
-        /// they are reflected in the iterative flow changes along reaches
-        //calc_output_flows();
-
-        if (bbopt->noisy_run || bbopt->debug_run) {
-          
-          std::cout << "-- cumqtransfer = " + std::to_string(cumqtransfer) 
-                    << " for nodes " << std::to_string(row->nodeID) << " -> " << std::to_string(row->adjnodeID) 
-                    << ", cid node original flow = "
-                    << std::to_string(depthrow1->flow) << ", updated flow = "
-                    << std::to_string(temp_sn1->output_flows[0])
-                    << ", adjid node original flow = "
-                    << std::to_string(depthrow2->flow) << ", updated flow = "
-                    << std::to_string(temp_sn2->output_flows[0]) << std::endl;
-          
+
+        // clamp the transfer rate with bounds
+        spill_transfer &st = transfers[s];
+        st.ind1 = ind1;
+        st.ind2 = ind2;
+        st.Q1 = (*bbsn)[ind1]->output_flows[f];
+        st.Q2 = (*bbsn)[ind2]->output_flows[f];
+        st.minQ1 = (*hyd_result)[f * total_nodes + ind1]->flow * coeff_min_flow;
+        st.minQ2 = (*hyd_result)[f * total_nodes + ind2]->flow * coeff_min_flow;
+        st.maxChange1 = st.Q1 * coeff_qi_rate;
+        st.maxChange2 = st.Q2 * coeff_qi_rate;
+        st.transfer = spill_conn.seg_transfer[s];
+
+        cumqtransfer = clamp_transfer(cumqtransfer,
+                                      st.Q1, st.Q2,
+                                      st.minQ1, st.minQ2,
+                                      st.maxChange1, st.maxChange2);
+
+        // set to zero to prevent transfer of flow from DS -> US node. US -> DS is ok
+        if ((st.transfer == 1 && cumqtransfer < 0) ||
+            (st.transfer == -1 && cumqtransfer > 0)) {
+          cumqtransfer = 0.0;
+          blocked[s] = 1;
         }
+        g[s] = cumqtransfer;
+      }
+    });
 
-        // reset cumulative flow transfer calculation for next streamnode
-        cumqtransfer = 0.0; 
+    double max_spillheightdiff = 0.0; // max difference in spill height between streamnodes (used to compute flow transfer rate)
+    for (int c = 0; c < num_chunks; c++) {
+      max_spillheightdiff = std::max(max_spillheightdiff, chunk_max[c]);
+    }
+
+    // if the iteration is tracked (i.e., accelerated or its convergence written), the accelerated transfers
+    // are bounded again, as the extrapolation may leave the bounds
+    bool track = f < spill_accel.size();
+    std::vector<double> x_next;
+    if (track) {
+      x_next = accelerate_spill_transfers(spill_accel[f], g, bbopt->spill_acceleration, bbopt->spill_anderson_depth);
+      spill_accel[f].x.resize(num_segments);
+    }
+
+    // update flow sources
+    for (int s = 0; s < num_segments; s++) {
+      const spill_transfer &st = transfers[s];
+      CStreamnode *temp_sn1 = (*bbsn)[st.ind1];
+      CStreamnode *temp_sn2 = (*bbsn)[st.ind2];
+      double cumqtransfer = track ? bound_spill_transfer(x_next[s], st) : g[s];
+      temp_sn1->flow_sources[f] += cumqtransfer*(-1);
+      temp_sn2->flow_sources[f] += cumqtransfer;
+      if (track) {
+        spill_accel[f].x[s] = cumqtransfer;
       }
-  }
+
+      if (blocked[s] && bbopt->debug_run) {
+        std::cout << "setting cumqtransfer to zero for nodes "
+        << std::to_string(temp_sn1->nodeID) << " -> "
+        << std::to_string(temp_sn2->nodeID) << std::endl;
+      }
+
+      if (bbopt->noisy_run || bbopt->debug_run) {
+        std::cout << "-- cumqtransfer = " + std::to_string(cumqtransfer) 
+                  << " for nodes " << std::to_string(temp_sn1->nodeID) << " -> " << std::to_string(temp_sn2->nodeID) 
+                  << ", cid node original flow = "
+                  << std::to_string((*hyd_result)[f * total_nodes + st.ind1]->flow) << ", updated flow = "
+                  << std::to_string(temp_sn1->output_flows[f])
+                  << ", adjid node original flow = "
+                  << std::to_string((*hyd_result)[f * total_nodes + st.ind2]->flow) << ", updated flow = "
+                  << std::to_string(temp_sn2->output_flows[f]) << std::endl;
+      }
+    }
 
   if (bbopt->debug_run) {
     double sum_sources = 0.0;
     for (int i = 0; i < bbsn->size(); ++i) {
-        for (double s : (*bbsn)[i]->flow_sources) {
-            sum_sources += s;
-        }
+        sum_sources += (*bbsn)[i]->flow_sources[f];
     }
-    std::cout << "Sum of flow_sources = " << sum_sources << std::endl;
+    std::cout << "Sum of flow_sources = " << sum_sources << " for flow profile " << fp_names[f] << std::endl;
   }
 
   return max_spillheightdiff; // return max spill height diff to evaluate against threshold
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Iterates on spill flows and hydraulic profiles until the spill flows of every flow profile converge
+/// \note each flow profile tracks its own convergence and is retired once converged, after which its
+/// sources, flows and hydraulic results are left as they are. The spill flows of active profiles are
+/// updated concurrently, and their hydraulic profiles are computed together by hyd_compute_profile.
+/// If requested, the iteration is accelerated and its convergence history written to SpillFlowConvergence.csv
+//
+void CModel::compute_spill_flows() {
+  int num_fp = fp_names.size();
+  int total_nodes = bbsn->size();
+  std::vector<char> fp_active(num_fp, 1);
+  std::vector<double> spilldepth(num_fp, -99);
+  std::vector<double> spilldepthprev(num_fp, -99);
+  int num_active = num_fp;
+  int num_threads = resolve_num_threads(bbopt->num_threads, std::numeric_limits<int>::max());
+
+  spill_accel.clear();
+  std::ofstream CONV;
+  if (bbopt->spill_acceleration != enum_sa_method::NO_ACCELERATION || bbopt->write_spill_convergence) {
+    spill_accel.assign(num_fp, spill_acceleration());
+  }
+  if (bbopt->write_spill_convergence) {
+    std::string tmpFilename = FilenamePrepare("SpillFlowConvergence.csv");
+    CONV.open(tmpFilename.c_str());
+    if (CONV.fail()) {
+      ExitGracefully(("CModel::compute_spill_flows: Unable to open output file " + tmpFilename + " for writing.").c_str(), FILE_OPEN_ERR);
+    }
+    CONV << "iteration,flowProfile,method,spillDepth,residualNorm,residualMax,relaxation,andersonDepth" << std::endl;
+  }
+
+  int kk = 0; // counter for spillflows iterations
+  while (kk <= bbopt->iteration_limit_spillflows && num_active > 0) {
+
+    if (!bbopt->silent_run) {
+      std::cout << "Spill Flow Iteration " << std::to_string(kk+1) << " === " << num_active << " of "
+                << num_fp << " flow profile(s) active" << std::endl;
+    }
+
+    // compute spill flows for each segment of spill_conn and update sources of each active flow profile
+    // threads are spread over active profiles first; any left over are used for segments within each profile
+    int fp_threads = std::min(num_threads, std::max(num_active, 1));
+    int seg_threads = std::max(num_threads / fp_threads, 1);
+    parallel_for(num_fp, fp_threads, [&](int f) {
+      if (!fp_active[f]) {
+        return;
+      }
+      zero_flow_sources(f); // zero sources before computing spill flows
+      spilldepth[f] = update_spill_flows(f, seg_threads);
+    });
+
+    // recalculate flows, keeping the flows of retired profiles since calc_output_flows_headwaternode
+    // adds the sources of headwaters to their flows on every pass
+    std::vector<double> retired_flows;
+    for (int f = 0; f < num_fp; f++) {
+      for (int i = 0; !fp_active[f] && i < total_nodes; i++) {
+        retired_flows.push_back((*bbsn)[i]->output_flows[f]);
+      }
+    }
+    if (bbopt->incremental_spill_flows) {
+      calc_output_flows_incremental();
+    } else {
+      calc_output_flows();
+    }
+    for (int f = 0, k = 0; f < num_fp; f++) {
+      for (int i = 0; !fp_active[f] && i < total_nodes; i++) {
+        (*bbsn)[i]->output_flows[f] = retired_flows[k++];
+      }
+    }
+
+    // re-run hyd_compute_profile for active profiles
+    hyd_compute_profile(bbopt->incremental_spill_flows, &fp_active);
+
+    for (int f = 0; f < num_fp; f++) {
+      if (!fp_active[f]) {
+        continue;
+      }
+      if (CONV.is_open()) {
+        CONV << kk + 1 << "," << fp_names[f] << "," << toString(bbopt->spill_acceleration) << ","
+             << spilldepth[f] << "," << spill_accel[f].residual_norm << "," << spill_accel[f].residual_max << ","
+             << spill_accel[f].omega << "," << spill_accel[f].dx.size() << std::endl;
+      }
+      if ((spilldepth[f] < bbopt->tolerance_spillflows) || spilldepth[f] == 0.0 ||
+          (kk > 1 && std::abs(spilldepth[f] - spilldepthprev[f]) < bbopt->spilldepthchangetol)) {
+        WriteAdvisory("Spill flow calculations for flow profile " + fp_names[f] + " converged after " +
+                          std::to_string(kk + 1) + " iterations with a spilldepth of " + std::to_string(spilldepth[f]) +
+                          " and a change in spilldepth of " + std::to_string(std::abs(spilldepth[f] - spilldepthprev[f])),
+                      bbopt->noisy_run || bbopt->debug_run);
+        fp_active[f] = 0;
+        num_active--;
+      } else {
+        spilldepthprev[f] = spilldepth[f];
+      }
+    }
+    if (num_active > 0) {
+      kk = kk + 1;
+    }
+  }
+
+  for (int f = 0; f < num_fp; f++) {
+    if (fp_active[f]) {
+      WriteWarning("Spill flow calculations for flow profile " + fp_names[f] +
+                       " exiting after max number of iterations and a spilldpeth of " + std::to_string(spilldepth[f]),
+                   bbopt->noisy_run);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Deletes hyd_result and all of its hydraulic outputs
+//
+void CModel::clear_hyd_result() {
+  if (hyd_result) {
+    for (auto ptr : *hyd_result) {
+      delete ptr;
+    }
+    delete hyd_result;
+    hyd_result = nullptr;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Adds the steady flows of all ensemble members at a streamnode
+/// \param sid [in] id of streamnode
+/// \param flows [in] steady flow of each ensemble member, in the order of ens_member_names
+//
+void CModel::add_ensemble_flows(int sid, const std::vector<double> &flows) {
+  int ind = get_index_by_id(sid);
+  ExitGracefullyIf(ind == PLACEHOLDER,
+                   ("Model.cpp: add_ensemble_flows: streamnode " + std::to_string(sid) + " does not exist").c_str(),
+                   exitcode::BAD_DATA);
+  ExitGracefullyIf(flows.size() != ens_member_names.size(),
+                   ("Model.cpp: add_ensemble_flows: streamnode " + std::to_string(sid) + " has " +
+                    std::to_string(flows.size()) + " flows for " + std::to_string(ens_member_names.size()) +
+                    " ensemble members").c_str(),
+                   exitcode::BAD_DATA);
+  ens_nodes.push_back(ind);
+  ens_flows.insert(ens_flows.end(), flows.begin(), flows.end());
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Sets the flow profiles of all streamnodes to a batch of ensemble members
+/// \note the flow vectors of each streamnode are sized to the batch, so that memory does not grow with the
+/// number of members, and hydraulic results of the previous batch are deleted
+/// \param first [in] index of first ensemble member of the batch
+/// \param num [in] number of ensemble members in the batch
+//
+void CModel::load_ensemble_batch(int first, int num) {
+  int num_members = ens_member_names.size();
+  fp_names.assign(ens_member_names.begin() + first, ens_member_names.begin() + first + num);
+  for (CStreamnode *sn : *bbsn) {
+    sn->upstream_flows.assign(num, PLACEHOLDER);
+    sn->flow_sources.assign(num, 0.0);
+    sn->flow_sinks.assign(num, 0.0);
+    sn->output_flows.assign(num, PLACEHOLDER);
+    sn->output_depths.assign(num, PLACEHOLDER);
+    sn->output_wsls.assign(num, PLACEHOLDER);
+  }
+  for (int r = 0; r < ens_nodes.size(); r++) {
+    CStreamnode *sn = (*bbsn)[ens_nodes[r]];
+    for (int f = 0; f < num; f++) {
+      sn->output_flows[f] = ens_flows[(long)r * num_members + first + f];
+      sn->upstream_flows[f] = HEADWATER;
+    }
+  }
+  clear_hyd_result();
+  prev_net_sources.clear();
+  sn_telemetry.clear(); // telemetry is per member, so it is not kept across batches
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Solves all ensemble members in batches, and replaces the flow profiles with the quantiles of
+/// member depths at each streamnode
+/// \note members of a batch are computed as flow profiles by hyd_compute_profile (and compute_spill_flows,
+/// if enabled), so they are solved in parallel. Only the depth of each streamnode and member is kept, in
+/// ens_depths. Each quantile profile is the member of nearest rank by depth at each streamnode, so that
+/// post processing of the quantile profiles gives quantiles of pixel depths for catchment hand methods
+//
+void CModel::compute_ensemble() {
+  int num_members = ens_member_names.size();
+  int total_nodes = bbsn->size();
+  ExitGracefullyIf(num_members == 0,
+                   "Model.cpp: compute_ensemble: no ensemble members were provided in :SteadyFlows",
+                   exitcode::BAD_DATA);
+
+  ens_depths.assign((long)total_nodes * num_members, 0.0f);
+  std::vector<float> member_flows((long)total_nodes * num_members, 0.0f);
+  for (int first = 0; first < num_members; first += bbopt->ensemble_batch_size) {
+    int num = std::min(bbopt->ensemble_batch_size, num_members - first);
+    if (!bbopt->silent_run) {
+      std::cout << "Computing ensemble members " << first + 1 << " to " << first + num << " of "
+                << num_members << std::endl;
+    }
+    load_ensemble_batch(first, num);
+    calc_output_flows();
+    hyd_compute_profile();
+    if (bbopt->enable_spill_flows) {
+      compute_spill_flows();
+    }
+
+    // keep depths and flows of the batch, with missing or invalid depths as dry
+    for (int f = 0; f < num; f++) {
+      for (int i = 0; i < total_nodes; i++) {
+        hydraulic_output *ho = (*hyd_result)[f * total_nodes + i];
+        double depth = ho == nullptr || std::isnan(ho->depth) || ho->depth == PLACEHOLDER || ho->depth < 0.0 ? 0.0 : ho->depth;
+        ens_depths[(long)i * num_members + first + f] = (float)depth;
+        member_flows[(long)i * num_members + first + f] = (float)(*bbsn)[i]->output_flows[f];
+      }
+    }
+  }
+
+  sn_telemetry.clear(); // telemetry of the last batch does not match the quantile profiles
+
+  // sort the depths of each streamnode, picking the member of nearest rank for each quantile
+  int num_q = bbopt->ensemble_quantiles.size();
+  std::vector<hydraulic_output *> *quantiles = new std::vector<hydraulic_output *>((long)num_q * total_nodes, nullptr);
+  parallel_for(total_nodes, bbopt->num_threads, [&](int i) {
+    float *depths = &ens_depths[(long)i * num_members];
+    std::vector<int> order(num_members);
+    for (int m = 0; m < num_members; m++) {
+      order[m] = m;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return depths[a] < depths[b]; });
+
+    CStreamnode *sn = (*bbsn)[i];
+    for (int q = 0; q < num_q; q++) {
+      int m = order[(int)std::lround(bbopt->ensemble_quantiles[q] * (num_members - 1))];
+      hydraulic_output *ho = new hydraulic_output();
+      ho->nodeID = sn->nodeID;
+      ho->reachID = sn->reachID;
+      ho->downnodeID = sn->downnodeID;
+      ho->upnodeID1 = sn->upnodeID1;
+      ho->upnodeID2 = sn->upnodeID2;
+      ho->stationname = sn->stationname;
+      ho->station = sn->station;
+      ho->reach_length_DS = sn->ds_reach_length;
+      ho->reach_length_US1 = sn->us_reach_length1;
+      ho->reach_length_US2 = sn->us_reach_length2;
+      ho->min_elev = sn->min_elev;
+      ho->bed_slope = sn->bed_slope;
+      ho->flow = member_flows[(long)i * num_members + m];
+      ho->depth = depths[m];
+      ho->wsl = sn->min_elev + ho->depth;
+      (*quantiles)[(long)q * total_nodes + i] = ho;
+    }
+    std::sort(depths, depths + num_members);
+  });
+
+  // the quantiles become the flow profiles used by post processing and outputs
+  clear_hyd_result();
+  hyd_result = quantiles;
+  fp_names.clear();
+  for (double q : bbopt->ensemble_quantiles) {
+    std::ostringstream name;
+    name << "q" << q * 100;
+    fp_names.push_back(name.str());
+  }
+  for (int i = 0; i < total_nodes; i++) {
+    CStreamnode *sn = (*bbsn)[i];
+    sn->upstream_flows.assign(num_q, PLACEHOLDER);
+    sn->flow_sources.assign(num_q, 0.0);
+    sn->flow_sinks.assign(num_q, 0.0);
+    sn->output_flows.assign(num_q, PLACEHOLDER);
+    sn->output_depths.assign(num_q, PLACEHOLDER);
+    sn->output_wsls.assign(num_q, PLACEHOLDER);
+    for (int q = 0; q < num_q; q++) {
+      hydraulic_output *ho = (*hyd_result)[(long)q * total_nodes + i];
+      sn->output_flows[q] = ho->flow;
+      sn->output_depths[q] = ho->depth;
+      sn->output_wsls[q] = ho->wsl;
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Add streamnode to model and map
 /// \param pSN [in] pointer reference to CStreamnode being added
@@ -683,10 +1430,9 @@ CStreamnode* CModel::get_streamnode_by_id(int sid) const {
 /// \param sid [in] id of streamnode to get index of
 /// \return index of streamnode with id 'sid'
 //
-int CModel::get_index_by_id(int sid) {
-  return streamnode_map.find(sid) != streamnode_map.end()
-             ? streamnode_map[sid]
-             : PLACEHOLDER;
+int CModel::get_index_by_id(int sid) const {
+  auto it = streamnode_map.find(sid);
+  return it != streamnode_map.end() ? it->second : PLACEHOLDER;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -695,7 +1441,7 @@ int CModel::get_index_by_id(int sid) {
 /// \param sid [in] id of streamnode to get index of
 /// \return index in hyd_result of streamnode with id 'sid' and a flow index of flow_ind
 //
-int CModel::get_hyd_res_index(int flow_ind, int sid) {
+int CModel::get_hyd_res_index(int flow_ind, int sid) const {
   return flow_ind * bbsn->size() + get_index_by_id(sid);
 }
 
@@ -708,6 +1454,245 @@ void CModel::add_snconntbl_row(streamnodeconn *&row) {
   snconntbl->push_back(row);
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Builds the columnar hydraulic table of all streamnodes from their depthdf
+/// \note called once after the geometry file has been parsed. If bbopt->resample_depth_step is set,
+/// the tables of reach streamnodes are resampled onto a uniform depth grid and the maximum
+/// interpolation error introduced is reported
+//
+void CModel::build_hydtables() {
+  for (CStreamnode *sn : *bbsn) {
+    sn->build_hydtable();
+  }
+  crit_curves = std::vector<critical_depth_curve>(bbsn->size());
+
+  if (bbopt->resample_depth_step == PLACEHOLDER) {
+    return;
+  }
+  int num_resampled = 0;
+  int max_err_nodeID = PLACEHOLDER;
+  double max_err = 0.0;
+  for (CStreamnode *sn : *bbsn) {
+    if (sn->nodetype != enum_nodetype::REACH || sn->hydtable.wsl.size() < 2) {
+      continue;
+    }
+    double err = sn->resample_hydtable(bbopt->resample_depth_step);
+    num_resampled++;
+    if (max_err_nodeID == PLACEHOLDER || err > max_err) {
+      max_err = err;
+      max_err_nodeID = sn->nodeID;
+    }
+  }
+
+  if (!bbopt->silent_run) {
+    std::cout << "Resampled depth tables of " << num_resampled
+              << " reach streamnodes to a depth step of " << bbopt->resample_depth_step << "m" << std::endl;
+    if (num_resampled > 0) {
+      std::cout << "Maximum relative interpolation error of resampled tables is " << max_err
+                << " at streamnode " << max_err_nodeID << std::endl;
+    }
+  }
+  if (max_err > 0.01) {
+    WriteAdvisory("Resampling depth tables introduced a maximum relative interpolation error of " +
+                      std::to_string(max_err) + " at streamnode " + std::to_string(max_err_nodeID) +
+                      ". Consider reducing the depth step in :ResampleDepthTable.",
+                  bbopt->noisy_run);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Builds the normal depth rating of all streamnodes from their hydtable
+/// \note called once after build_hydtables if bbopt->normal_depth_rating is set. Normal depths are then
+/// looked up from the rating for every flow profile rather than iterated
+//
+void CModel::build_normal_depth_ratings() {
+  if (!bbopt->normal_depth_rating) {
+    return;
+  }
+  long num_points = 0;
+  for (CStreamnode *sn : *bbsn) {
+    sn->build_normal_depth_rating(bbopt);
+    num_points += sn->ndrating.wsl.size();
+  }
+  if (!bbopt->silent_run) {
+    std::cout << "Built normal depth ratings of " << bbsn->size() << " streamnodes with "
+              << num_points << " rating points" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Compiles the stream network into index-based links and a traversal order for each boundary condition tree
+/// \note called once after all input files have been parsed. The traversal of each tree visits
+/// streamnodes in the same order as a depth-first walk upstream along upnodeID1 that returns to the
+/// most recent junction to take its upnodeID2 branch
+//
+void CModel::compile_topology() {
+  int total_nodes = bbsn->size();
+  sn_downind.assign(total_nodes, -1);
+  sn_upind1.assign(total_nodes, -1);
+  sn_upind2.assign(total_nodes, -1);
+  for (int i = 0; i < total_nodes; i++) {
+    CStreamnode *sn = (*bbsn)[i];
+    int ind;
+    ind = get_index_by_id(sn->downnodeID);
+    sn_downind[i] = ind == PLACEHOLDER ? -1 : ind;
+    ind = get_index_by_id(sn->upnodeID1);
+    sn_upind1[i] = ind == PLACEHOLDER ? -1 : ind;
+    ind = get_index_by_id(sn->upnodeID2);
+    sn_upind2[i] = ind == PLACEHOLDER ? -1 : ind;
+  }
+
+  // levels are filled along each downstream path, stopping at the first streamnode with a known level
+  sn_level.assign(total_nodes, -1);
+  std::vector<int> path;
+  for (int i = 0; i < total_nodes; i++) {
+    path.clear();
+    int curr = i;
+    while (curr != -1 && sn_level[curr] == -1) {
+      ExitGracefullyIf(path.size() > total_nodes,
+                       "Model.cpp: compile_topology(): loop found following downnodeID of streamnodes",
+                       BAD_DATA);
+      path.push_back(curr);
+      curr = sn_downind[curr];
+    }
+    int level = curr == -1 ? -1 : sn_level[curr];
+    for (int k = path.size() - 1; k >= 0; k--) {
+      sn_level[path[k]] = ++level;
+    }
+  }
+
+  // flow accumulation order, starting from the streamnodes without upstream streamnodes (i.e., headwaters)
+  // a streamnode with an upstream id not represented in streamnodes is never ready, and neither is anything downstream of it
+  std::vector<int> num_pending(total_nodes, 0);
+  std::vector<std::vector<int>> dependents(total_nodes);
+  for (int i = 0; i < total_nodes; i++) {
+    CStreamnode *sn = (*bbsn)[i];
+    for (int up : {sn_upind1[i], sn_upind2[i]}) {
+      if (up != -1) {
+        num_pending[i]++;
+        dependents[up].push_back(i);
+      }
+    }
+    if ((sn->upnodeID1 != -1 && sn_upind1[i] == -1) || (sn->upnodeID2 != -1 && sn_upind2[i] == -1)) {
+      num_pending[i]++;
+    }
+  }
+  sn_flow_order.clear();
+  for (int i = 0; i < total_nodes; i++) {
+    if (num_pending[i] == 0) {
+      sn_flow_order.push_back(i);
+    }
+  }
+  for (int k = 0; k < sn_flow_order.size(); k++) {
+    for (int dep : dependents[sn_flow_order[k]]) {
+      if (--num_pending[dep] == 0) {
+        sn_flow_order.push_back(dep);
+      }
+    }
+  }
+  if (sn_flow_order.size() < total_nodes) {
+    WriteWarning("Model.cpp: compile_topology(): flows of " + std::to_string(total_nodes - sn_flow_order.size()) +
+                     " streamnodes cannot be accumulated from their upstream streamnodes and will not be calculated",
+                 bbopt->noisy_run);
+  }
+
+  bc_trees.clear();
+  std::vector<bool> visited(total_nodes, false);
+  for (int b = 0; b < bbbc->size(); b++) {
+    int root = get_index_by_id((*bbbc)[b]->nodeID);
+    ExitGracefullyIf(root == PLACEHOLDER,
+                     "Model.cpp: compile_topology(): boundary condition "
+                     "streamnode id not represented in streamnodes",
+                     BAD_DATA);
+
+    compiled_tree tree;
+    tree.bc_ind = b;
+
+    // pending branches as {first streamnode, downstream streamnode, position in order of spawning junction}
+    std::vector<std::array<int, 3>> pending = {{root, root, -1}};
+    while (!pending.empty()) {
+      std::array<int, 3> br = pending.back();
+      pending.pop_back();
+      if (br[2] != -1) {
+        tree.spawn[br[2]] = tree.branch.size();
+      }
+      tree.branch.push_back(tree.order.size());
+
+      int curr = br[0], down = br[1];
+      while (curr != -1) {
+        ExitGracefullyIf(visited[curr],
+                         ("Model.cpp: compile_topology(): streamnode " + std::to_string((*bbsn)[curr]->nodeID) +
+                          " is reached more than once from the boundary conditions, check for loops in the stream network").c_str(),
+                         BAD_DATA);
+        visited[curr] = true;
+        tree.order.push_back(curr);
+        tree.down.push_back(down);
+        tree.spawn.push_back(-1);
+        if (sn_upind2[curr] != -1) {
+          pending.push_back({sn_upind2[curr], curr, (int)tree.order.size() - 1});
+        }
+        down = curr;
+        curr = sn_upind1[curr];
+      }
+    }
+    bc_trees.push_back(tree);
+  }
+
+  if (!bbopt->silent_run) {
+    int num_computed = std::count(visited.begin(), visited.end(), true);
+    std::cout << "Compiled stream network of " << num_computed << " streamnodes into "
+              << bc_trees.size() << " boundary condition trees" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Compiles snconntbl into the segments of spill_conn, with streamnode ids resolved to indices in bbsn
+/// \note a segment is a run of consecutive rows with the same adjacent streamnode and reach, as grouped
+/// by the spill flow calculations
+//
+void CModel::compile_spill_connections() {
+  spill_conn = spill_connection_graph();
+  int num_rows = snconntbl->size();
+  spill_conn.row_ind1.reserve(num_rows);
+  spill_conn.row_minhand1.reserve(num_rows);
+  spill_conn.row_minhand2.reserve(num_rows);
+  spill_conn.row_minelev1.reserve(num_rows);
+  spill_conn.row_minelev2.reserve(num_rows);
+
+  for (int i = 0; i < num_rows; i++) {
+    streamnodeconn *row = (*snconntbl)[i];
+    int ind1 = get_index_by_id(row->nodeID);
+    int ind2 = get_index_by_id(row->adjnodeID);
+    ExitGracefullyIf(ind1 == PLACEHOLDER || ind2 == PLACEHOLDER,
+                     ("Model.cpp: compile_spill_connections(): snconntbl row " + std::to_string(i) +
+                      " connects streamnode " + std::to_string(row->nodeID) + " to streamnode " +
+                      std::to_string(row->adjnodeID) + ", which is not in the model").c_str(),
+                     exitcode::BAD_DATA);
+
+    if (i == 0 || ind2 != spill_conn.seg_ind2.back() || row->reachID != (*snconntbl)[i - 1]->reachID) {
+      spill_conn.seg_start.push_back(i);
+      spill_conn.seg_ind1.push_back(ind1);
+      spill_conn.seg_ind2.push_back(ind2);
+      spill_conn.seg_transfer.push_back(row->transfer);
+    }
+    // streamnode 1 and direction of transfer of a segment are those of its last row
+    spill_conn.seg_ind1.back() = ind1;
+    spill_conn.seg_transfer.back() = row->transfer;
+
+    spill_conn.row_ind1.push_back(ind1);
+    spill_conn.row_minhand1.push_back(row->minhand1);
+    spill_conn.row_minhand2.push_back(row->minhand2);
+    spill_conn.row_minelev1.push_back(row->minelev1);
+    spill_conn.row_minelev2.push_back(row->minelev2);
+  }
+  spill_conn.seg_start.push_back(num_rows);
+
+  if (!bbopt->silent_run && num_rows > 0) {
+    std::cout << "Compiled " << num_rows << " streamnode connections into "
+              << spill_conn.num_segments() << " spill flow segments" << std::endl;
+  }
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Reads GIS files required for model
 //
@@ -735,6 +1720,11 @@ void CModel::ReadGISFiles() {
       std::cout << "Reading from NetCDF" << std::endl;
     }
     bbopt->in_format = enum_gridded_format::NETCDF;
+    if (bbopt->postproc_tile_memory > 0) {
+      WriteWarning("Model.cpp: ReadGISFiles: :PostprocessingTileMemory is only supported for raster inputs, the NetCDF file will be read in full",
+                   bbopt->noisy_run);
+      bbopt->postproc_tile_memory = 0.0;
+    }
     ReadNetCDFFile(bbopt->gis_path + "/" + bbopt->in_nc_name);
   } else {
     if (!bbopt->silent_run) {
@@ -742,13 +1732,29 @@ void CModel::ReadGISFiles() {
       std::cout << "Reading from Rasters" << std::endl;
     }
 
+    // rasters are only opened here if streamed, and are read in rows of at most bbopt->postproc_tile_memory in post processing
+    if (bbopt->postproc_tile_memory > 0 &&
+        (bbopt->out_format != enum_gridded_format::RASTER || bbopt->ensemble_mode)) {
+      WriteWarning("Model.cpp: ReadGISFiles: :PostprocessingTileMemory is only supported for raster outputs without "
+                   ":EnsembleMode, rasters will be read in full",
+                   bbopt->noisy_run);
+      bbopt->postproc_tile_memory = 0.0;
+    }
+    bool read_data = bbopt->postproc_tile_memory <= 0;
+    if (!read_data && !bbopt->silent_run) {
+      std::cout << "Rasters will be streamed in rows during post processing" << std::endl;
+    }
+
     c_from_s = std::make_unique<CRaster>();
 
     bbopt->in_format = enum_gridded_format::RASTER;
-    ReadRasterFile(bbopt->gis_path + "/bb_catchments_fromstreamnodes.tif", dynamic_cast<CRaster *>(c_from_s.get()));
+    ReadRasterFile(bbopt->gis_path + "/bb_catchments_fromstreamnodes.tif", dynamic_cast<CRaster *>(c_from_s.get()), read_data, true);
     c_from_s->name = "Catchments from Streamnodes";
 
-    if (bbopt->extrachecks) {
+    if (bbopt->extrachecks && !read_data) {
+      WriteAdvisory("Model.cpp: ReadGISFiles: catchment ids of streamed rasters are not checked against the model streamnodes",
+                    bbopt->noisy_run);
+    } else if (bbopt->extrachecks) {
 
       // -------------------------------------------------------------
       // Collect unique IDs from catchment_from_streamnodes raster
@@ -756,7 +1762,7 @@ void CModel::ReadGISFiles() {
       std::unordered_set<int> catchment_ids;
 
       for (int j = 0; j < c_from_s->xsize * c_from_s->ysize; ++j) {
-        double v = c_from_s->data[j];
+        double v = c_from_s->get_value(j);
         if (!std::isnan(v) && v != c_from_s->na_val) {
           catchment_ids.insert(static_cast<int>(v));
         }
@@ -788,10 +1794,10 @@ void CModel::ReadGISFiles() {
         bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_HAND) { // no dhand
       hand = std::make_unique<CRaster>();
       handid = std::make_unique<CRaster>();
-      ReadRasterFile(bbopt->gis_path + "/bb_hand.tif",  dynamic_cast<CRaster *>(hand.get()));
+      ReadRasterFile(bbopt->gis_path + "/bb_hand.tif",  dynamic_cast<CRaster *>(hand.get()), read_data);
       hand->name = "HAND";
       if (bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_HAND) {
-        ReadRasterFile(bbopt->gis_path + "/bb_hand_pourpoint_id.tif",  dynamic_cast<CRaster *>(handid.get()));
+        ReadRasterFile(bbopt->gis_path + "/bb_hand_pourpoint_id.tif",  dynamic_cast<CRaster *>(handid.get()), read_data, true);
         handid->name = "HAND ID";
       }
     } else { // use dhand
@@ -799,17 +1805,32 @@ void CModel::ReadGISFiles() {
         std::stringstream stream;
         stream << std::fixed << std::setprecision(4) << d;
         dhand.push_back(std::make_unique<CRaster>());
-        ReadRasterFile(bbopt->gis_path + "/bb_dhand_depth_" + stream.str() + "m.tif", dynamic_cast<CRaster *>(dhand.back().get()));
+        ReadRasterFile(bbopt->gis_path + "/bb_dhand_depth_" + stream.str() + "m.tif", dynamic_cast<CRaster *>(dhand.back().get()), read_data);
         dhand.back()->name = "DHAND " + stream.str();
         if (bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_DHAND ||
             bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_DHAND_WSLCORR) {
           dhandid.push_back(std::make_unique<CRaster>());
-          ReadRasterFile(bbopt->gis_path + "/bb_dhand_pourpoint_id_depth_" + stream.str() + "m.tif", dynamic_cast<CRaster *>(dhandid.back().get()));
+          ReadRasterFile(bbopt->gis_path + "/bb_dhand_pourpoint_id_depth_" + stream.str() + "m.tif", dynamic_cast<CRaster *>(dhandid.back().get()), read_data, true);
           dhandid.back()->name = "DHAND ID " + stream.str();
         }
       }
     }
   }
+
+  // post processing is specialized on a single cell type for all dhand layers and one for all dhandid layers,
+  // so layers of mixed types are widened to double
+  for (std::vector<std::unique_ptr<CGriddedData>> *layers : {&dhand, &dhandid}) {
+    for (auto &layer : *layers) {
+      if (layer->cell_type != layers->front()->cell_type) {
+        WriteAdvisory(std::string("Model.cpp: ReadGISFiles: ") + (layers == &dhand ? "dhand" : "dhandid") +
+                      " layers are not all of the same datatype, and are held as double", bbopt->noisy_run);
+        for (auto &l : *layers) {
+          l->set_cell_type(CELL_FLOAT64);
+        }
+        break;
+      }
+    }
+  }
   if (!bbopt->silent_run) {
     std::cout << "...gridded data successfully read" << std::endl;
     std::cout << std::endl;
@@ -888,7 +1909,7 @@ void CModel::ReadNetCDFFile(std::string filename) {
   // Read layers
   c_from_s = std::make_unique<CNetCDFLayer>();
 
-  ReadNetCDFLayer(dynamic_cast<CNetCDFLayer *>(c_from_s.get()), ncid, "catchments_streamnodes", x_len, y_len, x_coords, y_coords, epsg);
+  ReadNetCDFLayer(dynamic_cast<CNetCDFLayer *>(c_from_s.get()), ncid, "catchments_streamnodes", x_len, y_len, x_coords, y_coords, epsg, -1, true);
   c_from_s->name = "Catchments from Streamnodes";
   if (bbopt->interpolation_postproc_method == enum_ppi_method::CATCHMENT_HAND ||
       bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_HAND) { // no dhand
@@ -897,7 +1918,7 @@ void CModel::ReadNetCDFFile(std::string filename) {
     ReadNetCDFLayer(dynamic_cast<CNetCDFLayer *>(hand.get()), ncid, "hand", x_len, y_len, x_coords, y_coords, epsg);
     hand->name = "HAND";
     if (bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_HAND) {
-      ReadNetCDFLayer(dynamic_cast<CNetCDFLayer *>(handid.get()), ncid, "handid", x_len, y_len, x_coords, y_coords, epsg);
+      ReadNetCDFLayer(dynamic_cast<CNetCDFLayer *>(handid.get()), ncid, "handid", x_len, y_len, x_coords, y_coords, epsg, -1, true);
       handid->name = "HAND ID";
     }
   } else { // use dhand
@@ -910,7 +1931,7 @@ void CModel::ReadNetCDFFile(std::string filename) {
       if (bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_DHAND ||
           bbopt->interpolation_postproc_method == enum_ppi_method::INTERP_DHAND_WSLCORR) {
         dhandid.push_back(std::make_unique<CNetCDFLayer>());
-        ReadNetCDFLayer(dynamic_cast<CNetCDFLayer *>(dhandid.back().get()), ncid, "dhandid", x_len, y_len, x_coords, y_coords, epsg, i);
+        ReadNetCDFLayer(dynamic_cast<CNetCDFLayer *>(dhandid.back().get()), ncid, "dhandid", x_len, y_len, x_coords, y_coords, epsg, i, true);
         dhandid.back()->name = "DHAND ID " + stream.str();
       }
     }
@@ -930,12 +1951,13 @@ void CModel::ReadNetCDFFile(std::string filename) {
 /// \param y_coords [in] y dimension data
 /// \param epsg [in] EPSG projection code of data
 /// \param depth_index [in] the index of dhand depth to be read, if applicable. DEFAULT VALUE = -1
+/// \param is_id [in] whether the layer holds ids (catchments or pourpoints), stored as int32 if integer. DEFAULT VALUE = false
 //
 void CModel::ReadNetCDFLayer(CNetCDFLayer *netcdf_obj, int ncid,
                              const std::string &var_name, int xsize, int ysize,
                              std::vector<double> x_coords,
                              std::vector<double> y_coords, std::string epsg,
-                             int depth_index) {
+                             int depth_index, bool is_id) {
   int varid;
   if (nc_inq_varid(ncid, var_name.c_str(), &varid) != NC_NOERR) {
     ExitGracefully(("Model.cpp: ReadNetCDFLayer: NetCDF file missing '" + var_name + "' variable.").c_str(),
@@ -953,49 +1975,45 @@ void CModel::ReadNetCDFLayer(CNetCDFLayer *netcdf_obj, int ncid,
     ExitGracefully(("Model.cpp: ReadNetCDFFile: failed to read datatype of variable" + var_name).c_str(), exitcode::RUNTIME_ERR);
   }
 
-  // Read data
-  netcdf_obj->data = static_cast<double *>(
-      CPLMalloc(sizeof(double) * netcdf_obj->xsize * netcdf_obj->ysize));
+  // Read data, storing values in their native type where it is exact: hand values as float and integer ids as int32
+  size_t start[3] = {(size_t)depth_index, 0, 0};
+  size_t count[3] = {1, (size_t)netcdf_obj->ysize, (size_t)netcdf_obj->xsize};
+  int status = NC_NOERR;
   if (netcdf_obj->datatype == NC_DOUBLE) { // reading double
-    if (depth_index < 0) { // reading 2d
-      if (nc_get_var_double(ncid, varid, netcdf_obj->data) != NC_NOERR) {
-        ExitGracefully("Model.cpp: ReadNetCDFFile: failed to read 2d data", exitcode::RUNTIME_ERR);
-      }
-    } else { // reading slice of 3d
-      size_t start[3] = {depth_index, 0, 0};
-      size_t count[3] = {1, netcdf_obj->ysize, netcdf_obj->xsize};
-      if (nc_get_vara_double(ncid, varid, start, count, netcdf_obj->data) != NC_NOERR) {
-        ExitGracefully("Model.cpp: ReadNetCDFFile: failed to read slice of 3d data", exitcode::RUNTIME_ERR);
-      }
-    }
-  } else if (netcdf_obj->datatype == NC_FLOAT) { // reading float and casting to double
-    float *temp = static_cast<float *>(
-        CPLMalloc(sizeof(float) * netcdf_obj->xsize * netcdf_obj->ysize));
-    if (depth_index < 0) { // reading 2d
-      if (nc_get_var_float(ncid, varid, temp) != NC_NOERR) {
-        ExitGracefully("Model.cpp: ReadNetCDFFile: failed to read 2d data", exitcode::RUNTIME_ERR);
-      }
-    } else { // reading slice of 3d
-      size_t start[3] = {depth_index, 0, 0};
-      size_t count[3] = {1, netcdf_obj->ysize, netcdf_obj->xsize};
-      if (nc_get_vara_float(ncid, varid, start, count, temp) != NC_NOERR) {
-        ExitGracefully("Model.cpp: ReadNetCDFFile: failed to read slice of 3d data", exitcode::RUNTIME_ERR);
-      }
-    }
-    for (size_t i = 0; i < netcdf_obj->xsize * netcdf_obj->ysize; i++) {
-      netcdf_obj->data[i] = static_cast<double>(temp[i]);
-    }
-    CPLFree(temp);
+    netcdf_obj->cell_type = CELL_FLOAT64;
+    netcdf_obj->allocate_data();
+    status = depth_index < 0 ? nc_get_var_double(ncid, varid, netcdf_obj->cells<double>())
+                             : nc_get_vara_double(ncid, varid, start, count, netcdf_obj->cells<double>());
+  } else if (netcdf_obj->datatype == NC_FLOAT && !is_id) { // reading float
+    netcdf_obj->cell_type = CELL_FLOAT32;
+    netcdf_obj->allocate_data();
+    status = depth_index < 0 ? nc_get_var_float(ncid, varid, netcdf_obj->cells<float>())
+                             : nc_get_vara_float(ncid, varid, start, count, netcdf_obj->cells<float>());
+  } else if (netcdf_obj->datatype == NC_FLOAT) { // reading float ids as double, as ids are only specialized as int32 or double
+    netcdf_obj->cell_type = CELL_FLOAT64;
+    netcdf_obj->allocate_data();
+    status = depth_index < 0 ? nc_get_var_double(ncid, varid, netcdf_obj->cells<double>())
+                             : nc_get_vara_double(ncid, varid, start, count, netcdf_obj->cells<double>());
+  } else if (netcdf_obj->datatype == NC_INT && is_id) { // reading int ids
+    netcdf_obj->cell_type = CELL_INT32;
+    netcdf_obj->allocate_data();
+    status = depth_index < 0 ? nc_get_var_int(ncid, varid, netcdf_obj->cells<int32_t>())
+                             : nc_get_vara_int(ncid, varid, start, count, netcdf_obj->cells<int32_t>());
   } else {
     ExitGracefully("Model.cpp: ReadNetCDFLayer: unsupported datatype", exitcode::BAD_DATA);
   }
+  if (status != NC_NOERR) {
+    ExitGracefully(depth_index < 0 ? "Model.cpp: ReadNetCDFFile: failed to read 2d data"
+                                   : "Model.cpp: ReadNetCDFFile: failed to read slice of 3d data",
+                   exitcode::RUNTIME_ERR);
+  }
 
   // Read _FillValue
-  float fill_value;
+  double fill_value;
   nc_type var_type;
   if (nc_inq_att(ncid, varid, "_FillValue", &var_type, nullptr) == NC_NOERR) {
-    nc_get_att_float(ncid, varid, "_FillValue", &fill_value);
-    netcdf_obj->na_val = static_cast<double>(fill_value);
+    nc_get_att_double(ncid, varid, "_FillValue", &fill_value);
+    netcdf_obj->na_val = fill_value;
   } else {
     netcdf_obj->na_val = std::numeric_limits<double>::quiet_NaN();
   }
@@ -1005,8 +2023,10 @@ void CModel::ReadNetCDFLayer(CNetCDFLayer *netcdf_obj, int ncid,
 /// \brief Reads specified Raster file
 /// \param filename [in] full path to raster file to read from
 /// \param raster_obj [in] pointer to CRaster object to write to
+/// \param read_data [in] if false, the data is not read and the dataset is kept open in raster_obj to be streamed in rows
+/// \param is_id [in] whether the raster holds ids (catchments or pourpoints), stored as int32 if integer
 //
-void CModel::ReadRasterFile(std::string filename, CRaster *raster_obj) {
+void CModel::ReadRasterFile(std::string filename, CRaster *raster_obj, bool read_data, bool is_id) {
   CPLPushErrorHandler(SilentErrorHandler);
   GDALDataset *dataset =
       static_cast<GDALDataset *>(GDALOpen(filename.c_str(), GA_ReadOnly));
@@ -1030,14 +2050,35 @@ void CModel::ReadRasterFile(std::string filename, CRaster *raster_obj) {
   }
   dataset->GetGeoTransform(raster_obj->geotrans);
 
-  raster_obj->data = static_cast<double *>(
-      CPLMalloc(sizeof(double) * raster_obj->xsize * raster_obj->ysize));
   GDALRasterBand *band = dataset->GetRasterBand(1);
   raster_obj->datatype = band->GetRasterDataType();
   raster_obj->na_val = band->GetNoDataValue();
+
+  // store values in their native type where it is exact: hand values as float and integer ids as int32
+  switch (raster_obj->datatype) {
+  case GDT_Byte:
+  case GDT_UInt16:
+  case GDT_Int16:
+    raster_obj->cell_type = is_id ? CELL_INT32 : CELL_FLOAT32;
+    break;
+  case GDT_Int32:
+    raster_obj->cell_type = is_id ? CELL_INT32 : CELL_FLOAT64;
+    break;
+  case GDT_Float32:
+    raster_obj->cell_type = is_id ? CELL_FLOAT64 : CELL_FLOAT32;
+    break;
+  default:
+    raster_obj->cell_type = CELL_FLOAT64;
+    break;
+  }
+  if (!read_data) {
+    raster_obj->dataset = dataset;
+    return;
+  }
+  raster_obj->allocate_data();
   band->RasterIO(GF_Read, 0, 0, raster_obj->xsize, raster_obj->ysize,
                  raster_obj->data, raster_obj->xsize, raster_obj->ysize,
-                 GDT_Float64, 0, 0);
+                 raster_obj->cell_gdal_type(), 0, 0);
   GDALClose(dataset);
 }
 
@@ -1093,7 +2134,7 @@ void CModel::postprocess_floodresults() {
   if (bbopt->interpolation_postproc_method == enum_ppi_method::NONE) {
     return;
   }
-  ExitGracefullyIf(!c_from_s || !c_from_s->data,
+  ExitGracefullyIf(!c_from_s || (!c_from_s->data && bbopt->postproc_tile_memory <= 0),
                    "Raster.cpp: postprocess_floodresults: catchments from "
                    "streamnodes missing",
                    exitcode::RUNTIME_ERR);
@@ -1102,36 +2143,50 @@ void CModel::postprocess_floodresults() {
       "Raster.cpp: postprocess_floodresults: hydraulic output missing",
       exitcode::RUNTIME_ERR);
   
-  // loop for each flow_profiles
-  for (int flow_ind = 0; flow_ind < bbsn->front()->output_flows.size(); flow_ind++) {
+  // loop for each block of bbopt->postproc_block_size flow profiles, post processed in a single pass over the rasters
+  int num_fp_total = bbsn->front()->output_flows.size();
+  int block_size = bbopt->postproc_block_size > 0 ? bbopt->postproc_block_size : std::max(num_fp_total, 1);
+  for (int flow_first = 0; flow_first < num_fp_total; flow_first += block_size) {
+    int num_fp = std::min(block_size, num_fp_total - flow_first);
     if (!bbopt->silent_run) {
-      std::cout << "post processing flood results for flow " + std::to_string(flow_ind + 1) << std::endl;
+      if (num_fp == 1) {
+        std::cout << "post processing flood results for flow " + std::to_string(flow_first + 1) << std::endl;
+      } else {
+        std::cout << "post processing flood results for flows " + std::to_string(flow_first + 1) + " to " +
+                     std::to_string(flow_first + num_fp) << std::endl;
+      }
     }
 
+    generate_catchment_depths(flow_first, num_fp);
+
     switch (bbopt->interpolation_postproc_method)
     {
     case (enum_ppi_method::CATCHMENT_HAND):
     {
-      generate_out_gridded(flow_ind, false, false);
+      generate_out_gridded(flow_first, num_fp, false, false);
       break;
     }
     case (enum_ppi_method::INTERP_HAND):
     {
-      generate_spp_depths(flow_ind);
-      generate_out_gridded(flow_ind, true, false);
+      for (int f = flow_first; f < flow_first + num_fp; f++) {
+        generate_spp_depths(f);
+      }
+      generate_out_gridded(flow_first, num_fp, true, false);
       break;
     }
     case (enum_ppi_method::CATCHMENT_DHAND):
     {
-      generate_dhand_vals(flow_ind, false);
-      generate_out_gridded(flow_ind, false, true);
+      generate_catchment_brackets();
+      generate_out_gridded(flow_first, num_fp, false, true);
       break;
     }
     case (enum_ppi_method::INTERP_DHAND):
     {
-      generate_spp_depths(flow_ind);
-      generate_dhand_vals(flow_ind, true);
-      generate_out_gridded(flow_ind, true, true);
+      for (int f = flow_first; f < flow_first + num_fp; f++) {
+        generate_spp_depths(f);
+      }
+      generate_catchment_brackets();
+      generate_out_gridded(flow_first, num_fp, true, true);
       break;
     }
     //case (enum_ppi_method::INTERP_DHAND_WSLCORR):
@@ -1150,8 +2205,12 @@ void CModel::postprocess_floodresults() {
     }
     } //end switch
 
-    spp_depths.clear(); // if applicable, clear spp_depths for next flow profile
-    dhand_vals.clear(); // if applicable, clear dhand_vals for next flow profile
+    spp_depths.clear(); // if applicable, clear spp_depths for next block of flow profiles
+  }
+  catch_depths.clear();
+  catch_brackets.clear();
+  if (bbopt->ensemble_mode) {
+    generate_ensemble_exceedance();
   }
   if (!bbopt->silent_run) {
     std::cout << "finished post processing flood results" << std::endl;
@@ -1165,35 +2224,63 @@ void CModel::postprocess_floodresults() {
 /// \param down_sn [in] streamnode one node downstream of sn
 /// \param res [in/out] object to add output to when done computing
 /// \param bc [in] boundary condition for current set of streamnodes
+/// \param ws [in/out] working state of the flow profile being computed
 //
-void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::vector<hydraulic_output *> *&res, CBoundaryCondition *&bc) {
-  if (!bbopt->silent_run) {
+void CModel::compute_streamnode(int ind, int down_ind, std::vector<hydraulic_output *> *&res, CBoundaryCondition *&bc, profile_workspace &ws) {
+  CStreamnode *sn = (*bbsn)[ind];
+  CStreamnode *down_sn = (*bbsn)[down_ind];
+
+  if (bbopt->noisy_run) { // per streamnode, so only when noisy as threads would otherwise contend on the stream
     std::cout << "Computing profile for streamnode with node id " << std::to_string(sn->nodeID) << std::endl;
   }
 
   static constexpr double FLOW_TOL = 1e-6;
 
+  // solver telemetry of this solve, accumulated into sn_telemetry on return if telemetry is on
+  auto t_start = std::chrono::steady_clock::now();
+  solver_telemetry tm;
+  auto record_telemetry = [&]() {
+    if (sn_telemetry.empty()) {
+      return;
+    }
+    solver_telemetry &acc = sn_telemetry[ws.flow * bbsn->size() + ind];
+    acc.path = tm.path;
+    acc.num_solves++;
+    acc.residual_evals += tm.residual_evals;
+    acc.energy_evals += tm.energy_evals;
+    acc.bracket_expansions += tm.bracket_expansions;
+    acc.critical_fallbacks += tm.critical_fallbacks;
+    acc.wall_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+  };
+
   // Initialize values
-  int ind = get_index_by_id(sn->nodeID);
-  sn->mm->nodeID = sn->nodeID;
-  sn->mm->reachID = sn->reachID;
-  sn->mm->downnodeID = sn->downnodeID;
-  sn->mm->upnodeID1 = sn->upnodeID1;
-  sn->mm->upnodeID2 = sn->upnodeID2;
-  sn->mm->stationname = sn->stationname;
-  sn->mm->station = sn->station;
-  sn->mm->min_elev = sn->min_elev;
-  sn->mm->reach_length_DS = sn->ds_reach_length;
-  sn->mm->reach_length_US1 = sn->us_reach_length1;
-  sn->mm->reach_length_US2 = sn->us_reach_length2;
-  sn->mm->bed_slope = sn->bed_slope;
-  sn->mm->flow = sn->output_flows[flow];
+  const int flow = ws.flow;
+  hydraulic_output *mm = &ws.mm[ind];
+  hydraulic_output *down_mm = &ws.mm[down_ind];
+  if (!solved_down_wsl.empty()) { // downstream state solved against, compared by compute_streamnode_incremental
+    solved_down_wsl[(long)flow * bbsn->size() + ind] = down_mm->wsl;
+    solved_down_vhead[(long)flow * bbsn->size() + ind] = down_mm->velocity_head;
+  }
+  mm->nodeID = sn->nodeID;
+  mm->reachID = sn->reachID;
+  mm->downnodeID = sn->downnodeID;
+  mm->upnodeID1 = sn->upnodeID1;
+  mm->upnodeID2 = sn->upnodeID2;
+  mm->stationname = sn->stationname;
+  mm->station = sn->station;
+  mm->min_elev = sn->min_elev;
+  mm->reach_length_DS = sn->ds_reach_length;
+  mm->reach_length_US1 = sn->us_reach_length1;
+  mm->reach_length_US2 = sn->us_reach_length2;
+  mm->bed_slope = sn->bed_slope;
+  mm->flow = sn->output_flows[flow];
 
   bool using_exhaustive = false; // by default, not using exhaustive solution until triggered
 
   if (sn->nodeID == bc->nodeID) { // boundary condition streamnode
+    tm.path = enum_solver_path::PATH_BOUNDARY_CONDITION;
     if (bbopt->modeltype == enum_mt_method::HAND_MANNING) {
-      sn->mm->wsl = sn->compute_normal_depth(sn->mm->flow, sn->mm->bed_slope, -99, bbopt);
+      mm->wsl = sn->compute_normal_depth(mm->flow, mm->bed_slope, -99, bbopt);
     } else { // bbopt->modeltype != enum_mt_method::HAND_MANNING
       // estimate first streamnode from supplied boundary conditions
       switch (bc->bctype)
@@ -1204,13 +2291,13 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                        "reasonable slope, please check!",
                        bbopt->noisy_run);
         }
-        sn->mm->wsl = sn->compute_normal_depth(sn->mm->flow, bc->bcvalue, bc->init_WSL, bbopt);
-        sn->mm->sf = bc->bcvalue; // override sf from preproc
+        mm->wsl = sn->compute_normal_depth(mm->flow, bc->bcvalue, bc->init_WSL, bbopt);
+        mm->sf = bc->bcvalue; // override sf from preproc
         break;
       }
       case (enum_bc_type::SET_WSL): {
-        sn->mm->wsl = bc->bcvalue;
-        ExitGracefullyIf(sn->mm->wsl < sn->mm->min_elev,
+        mm->wsl = bc->bcvalue;
+        ExitGracefullyIf(mm->wsl < mm->min_elev,
                          "Model.cpp: compute_streamnode: SET_WSL used as "
                          "boundary condition but value provided is less than "
                          "minimum elevation, revise boundary condition!",
@@ -1218,7 +2305,7 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
         break;
       }
       case (enum_bc_type::SET_DEPTH): {
-        sn->mm->wsl = bc->bcvalue + sn->mm->min_elev;
+        mm->wsl = bc->bcvalue + mm->min_elev;
         ExitGracefullyIf(bc->bcvalue < 0,
                          "Model.cpp: compute_streamnode: SET_DEPTH used as "
                          "boundary condition, value must be >= 0",
@@ -1233,68 +2320,76 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
       }
       }
     }
-    sn->mm->depth = sn->mm->wsl - sn->mm->min_elev;
-    sn->compute_profile(sn->mm->flow, sn->mm->wsl, bbopt);
+    mm->depth = mm->wsl - mm->min_elev;
+    sn->compute_profile(mm->flow, mm->wsl, mm, bbopt);
   } else { // not boundary condition node
     if (bbopt->modeltype == enum_mt_method::HAND_MANNING) {
-      sn->mm->wsl = sn->compute_normal_depth(sn->mm->flow, sn->mm->bed_slope, -99, bbopt);
-      sn->compute_profile(sn->mm->flow, sn->mm->wsl, bbopt);
+      tm.path = enum_solver_path::PATH_NORMAL_DEPTH;
+      mm->wsl = sn->compute_normal_depth(mm->flow, mm->bed_slope, -99, bbopt);
+      sn->compute_profile(mm->flow, mm->wsl, mm, bbopt);
     } else { // bbopt->modeltype != enum_mt_method::HAND_MANNING
-      //sn->mm->wsl = down_sn->mm->depth + sn->mm->min_elev; // best guess at upstream WSL, same depth applied to bottom bed elevation
-      sn->mm->depth = down_sn->mm->depth;
-      sn->mm->wsl = sn->mm->depth + sn->mm->min_elev;
+      //mm->wsl = down_mm->depth + mm->min_elev; // best guess at upstream WSL, same depth applied to bottom bed elevation
+      mm->depth = down_mm->depth;
+      mm->wsl = mm->depth + mm->min_elev;
 
-      if (sn->mm->flow <= FLOW_TOL) {
-        sn->mm->flow = 0.0;
-        sn->mm->depth = 0.0;
-        sn->mm->wsl = sn->mm->min_elev;
+      if (mm->flow <= FLOW_TOL) {
+        tm.path = enum_solver_path::PATH_ZERO_FLOW;
+        mm->flow = 0.0;
+        mm->depth = 0.0;
+        mm->wsl = mm->min_elev;
 
-        sn->compute_profile(sn->mm->flow, sn->mm->wsl, bbopt);
+        sn->compute_profile(mm->flow, mm->wsl, mm, bbopt);
 
         // Zero all hydraulic properties
-        sn->mm->velocity = 0.0;
-        sn->mm->velocity_head = 0.0;
-        sn->mm->energy_total = sn->mm->wsl;
-        sn->mm->froude = 0.0;
-        sn->mm->sf = 0.0;
-
-        sn->mm->k_total = 0.0;
-        sn->mm->alpha = 0.0;
-        sn->mm->area = 0.0;
-        sn->mm->hradius = 0.0;
-        sn->mm->wet_perimeter = 0.0;
-        sn->mm->manning_composite = 0.0;
-        sn->mm->length_effective = 0.0;
-        sn->mm->length_effectiveadjusted = 0.0;
-        sn->mm->hyd_depth = 0.0;
-        sn->mm->top_width = 0.0;
-
-        sn->mm->k_total_areaconv = 0.0;
-        sn->mm->k_total_disconv = 0.0;
-        sn->mm->k_total_roughconv = 0.0;
-
-        sn->mm->alpha_areaconv = 0.0;
-        sn->mm->alpha_disconv = 0.0;
-        sn->mm->alpha_roughconv = 0.0;
-
-        sn->mm->nc_equalforce = 0.0;
-        sn->mm->nc_equalvelocity = 0.0;
-        sn->mm->nc_wavgwp = 0.0;
-        sn->mm->nc_wavgarea = 0.0;
-        sn->mm->nc_wavgconv = 0.0;
+        mm->velocity = 0.0;
+        mm->velocity_head = 0.0;
+        mm->energy_total = mm->wsl;
+        mm->froude = 0.0;
+        mm->sf = 0.0;
+
+        mm->k_total = 0.0;
+        mm->alpha = 0.0;
+        mm->area = 0.0;
+        mm->hradius = 0.0;
+        mm->wet_perimeter = 0.0;
+        mm->manning_composite = 0.0;
+        mm->length_effective = 0.0;
+        mm->length_effectiveadjusted = 0.0;
+        mm->hyd_depth = 0.0;
+        mm->top_width = 0.0;
+
+        mm->k_total_areaconv = 0.0;
+        mm->k_total_disconv = 0.0;
+        mm->k_total_roughconv = 0.0;
+
+        mm->alpha_areaconv = 0.0;
+        mm->alpha_disconv = 0.0;
+        mm->alpha_roughconv = 0.0;
+
+        mm->nc_equalforce = 0.0;
+        mm->nc_equalvelocity = 0.0;
+        mm->nc_wavgwp = 0.0;
+        mm->nc_wavgarea = 0.0;
+        mm->nc_wavgconv = 0.0;
 
         // Peak hours required = 0 for zero flow
-        sn->mm->peak_hrs_required = 0.0;
+        mm->peak_hrs_required = 0.0;
 
         // Assign output safely
-        (*res)[flow * bbsn->size() + ind] = new hydraulic_output(*(sn->mm));
-        sn->output_depths[flow] = sn->mm->depth;
-        sn->output_wsls[flow] = sn->mm->wsl;
+        int out_index = flow * bbsn->size() + ind;
+        if ((*res)[out_index] == nullptr) {
+          (*res)[out_index] = new hydraulic_output(*(mm));
+        } else {
+          *(*res)[out_index] = *(mm);
+        }
+        sn->output_depths[flow] = mm->depth;
+        sn->output_wsls[flow] = mm->wsl;
 
         // No profile computation needed
+        record_telemetry();
         return;
       } else {
-          if (bbopt->solvermethod == enum_sm_method::BRENT) {
+          if (bbopt->solvermethod == enum_sm_method::BRENT || bbopt->solvermethod == enum_sm_method::NEWTON) {
 
               /* if (bbopt->noisy_run) {
                 std::cout << "Using Brent method to solve for depth at streamnode "
@@ -1303,14 +2398,16 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
 
               // compute critical depth
               // // xxx to resolve - cannot seem to get the derivative version of critical_wsl_brent working in any way. Reverting to exhaustive search for now.
-              // double wsl_critical = solve_critical_wsl_brent(sn, down_sn);
-              // double wsl_critical = solve_critical_wsl_brent_analytical(sn, down_sn);
-              // double wsl_critical = solve_critical_wsl_brent(sn, down_sn);   
-              double wsl_critical = solve_critical_wsl_exhaustive(sn, down_sn);                         
+              // double wsl_critical = solve_critical_wsl_brent(sn, down_sn, mm, down_mm);
+              // double wsl_critical = solve_critical_wsl_brent_analytical(sn, down_sn, mm, down_mm);
+              // double wsl_critical = solve_critical_wsl_brent(sn, down_sn, mm, down_mm);   
+              double wsl_critical = bbopt->critical_depth_cache
+                                        ? solve_critical_wsl_cached(ind, sn, mm, ws, tm)
+                                        : solve_critical_wsl_exhaustive(sn, down_sn, mm, down_mm, tm);
 
               // convert to depth
-              double depth_critical = wsl_critical - sn->mm->min_elev;
-              sn->mm->depth_critical = depth_critical;
+              double depth_critical = wsl_critical - mm->min_elev;
+              mm->depth_critical = depth_critical;
 
               // checks for critical depth ~= 0
               if (depth_critical < 0.01) {
@@ -1319,28 +2416,47 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                      bbopt->noisy_run);
               }
 
-              // calculate wsl_estimated using Brent method
-              double wsl_estimated = solve_wsl_standard_step_brent(
+              // calculate wsl_estimated using Brent or Newton method
+              double wsl_prior = ws.prior_wsl.empty() ? PLACEHOLDER : ws.prior_wsl[ind];
+              double wsl_estimated = PLACEHOLDER;
+              if (bbopt->solvermethod == enum_sm_method::NEWTON) {
+                tm.path = enum_solver_path::PATH_NEWTON;
+                wsl_estimated = solve_wsl_standard_step_newton(sn, down_sn, mm, down_mm, wsl_critical, wsl_prior, tm);
+              } else {
+                tm.path = enum_solver_path::PATH_BRENT;
+                wsl_estimated = solve_wsl_standard_step_brent(
                     sn,          // upstream node
                     down_sn,     // downstream node
-                    wsl_critical // critical depth used to bound the solution space for the Brent method
+                    mm,          // working state of upstream node
+                    down_mm,     // working state of downstream node
+                    wsl_critical, // critical depth used to bound the solution space for the Brent method
+                    wsl_prior,   // prior wsl used to warm start the bracket, PLACEHOLDER if none
+                    tm           // telemetry of the solve, counting residual evaluations used
                 );
+              }
+              if (wsl_prior != PLACEHOLDER) {
+                ws.num_warm_solves++;
+                ws.warm_evals += tm.residual_evals;
+              } else {
+                ws.num_cold_solves++;
+                ws.cold_evals += tm.residual_evals;
+              }
 
-              // set depth in sn based on wsl_estimated from the Brent method
-              sn->mm->wsl = wsl_estimated;
-              sn->mm->depth_critical = wsl_critical - sn->mm->min_elev;
-              sn->mm->depth          = sn->mm->wsl - sn->mm->min_elev;
-              sn->compute_profile_next(sn->mm->flow, sn->mm->wsl, down_sn->mm, bbopt);
-              double wsl_error = sn->get_wsl_error(sn->mm->wsl, down_sn->mm, bbopt);
-              sn->mm->ws_err = wsl_error;
-              sn->mm->k_err = sn->mm->flow - sn->mm->k_total * std::sqrt(sn->mm->sf);
+              // set depth in sn based on wsl_estimated from the solver
+              mm->wsl = wsl_estimated;
+              mm->depth_critical = wsl_critical - mm->min_elev;
+              mm->depth          = mm->wsl - mm->min_elev;
+              sn->compute_profile_next(mm->flow, mm->wsl, mm, down_mm, bbopt);
+              double wsl_error = sn->get_wsl_error(mm->wsl, mm, down_mm, bbopt);
+              mm->ws_err = wsl_error;
+              mm->k_err = mm->flow - mm->k_total * std::sqrt(mm->sf);
 
               // perform checks on the results
 
               // check if wsl_estimated is at the upper bound
-              if (sn->mm->depth >= sn->depthdf->back()->depth*0.99) {
+              if (mm->depth >= sn->depthdf->back()->depth*0.99) {
               WriteWarning(
-                          "Estimated depth at streamnode " + std::to_string(sn->nodeID) + " is " + std::to_string(sn->mm->depth) + "m, which is at the available upper bound. The preprocesed table max depth may need to be increased.",
+                          "Estimated depth at streamnode " + std::to_string(sn->nodeID) + " is " + std::to_string(mm->depth) + "m, which is at the available upper bound. The preprocesed table max depth may need to be increased.",
                           bbopt->noisy_run);
               }
               // check the wsl_error from wsl determined by Brent, and report if it exceeds threshold
@@ -1351,9 +2467,9 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
               }
               */
               // check froude number
-              if (sn->mm->froude > bbopt->froude_threshold) {
+              if (mm->froude > bbopt->froude_threshold) {
               WriteAdvisory(
-                          "Froude number at streamnode " + std::to_string(sn->nodeID) + " is " + std::to_string(sn->mm->froude) + ", which indicates that the regime here may be supercritical.",
+                          "Froude number at streamnode " + std::to_string(sn->nodeID) + " is " + std::to_string(mm->froude) + ", which indicates that the regime here may be supercritical.",
                           bbopt->noisy_run);
               }
       
@@ -1365,23 +2481,25 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                  actual_err = PLACEHOLDER, min_fr = PLACEHOLDER,
                  proposed_wsl = PLACEHOLDER;
           bool found_supercritical = false; // reset before every i iteration, use in iteration as needed
+          tm.path = enum_solver_path::PATH_SECANT;
 
           for (int i = 0; i < bbopt->iteration_limit_cp; i++) {
             prevWSL_lag2 = prevWSL_lag1;
-            prevWSL_lag1 = sn->mm->wsl;
-            sn->compute_profile_next(sn->mm->flow, sn->mm->wsl, down_sn->mm, bbopt);
+            prevWSL_lag1 = mm->wsl;
+            sn->compute_profile_next(mm->flow, mm->wsl, mm, down_mm, bbopt);
+            tm.residual_evals++;
 
-            double max_depth_change = std::max(0.5 * sn->mm->depth, 0.5);
-            double comp_wsl = down_sn->mm->wsl + down_sn->mm->velocity_head +
-                              sn->mm->head_loss - sn->mm->velocity_head;
+            double max_depth_change = std::max(0.5 * mm->depth, 0.5);
+            double comp_wsl = down_mm->wsl + down_mm->velocity_head +
+                              mm->head_loss - mm->velocity_head;
 
             // checks/modifications against min_elev
-            if (comp_wsl <= sn->mm->min_elev) {
+            if (comp_wsl <= mm->min_elev) {
               comp_wsl =
-                  sn->mm->flow == 0
-                      ? sn->mm->min_elev
+                  mm->flow == 0
+                      ? mm->min_elev
                       : std::max(comp_wsl,
-                                 sn->mm->min_elev + 0.05 +
+                                 mm->min_elev + 0.05 +
                                      0.05 *
                                          (1 - (i + 1) / bbopt->iteration_limit_cp));
             }
@@ -1398,12 +2516,12 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
               min_err = std::abs(err_lag1);
               actual_err = err_lag1;
               min_err_wsl = prevWSL_lag1;
-              min_fr = sn->mm->froude;
+              min_fr = mm->froude;
             }
 
-            sn->mm->ws_err = err_lag1;
-            sn->mm->k_err = sn->mm->flow - sn->mm->k_total * std::sqrt(sn->mm->sf);
-            sn->mm->cp_iterations = i + 1;
+            mm->ws_err = err_lag1;
+            mm->k_err = mm->flow - mm->k_total * std::sqrt(mm->sf);
+            mm->cp_iterations = i + 1;
 
             if (using_exhaustive) {
               err_lag1 =
@@ -1418,13 +2536,13 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                     bbopt->noisy_run);
 
                 // setting to min error result
-                sn->compute_profile_next(sn->mm->flow, min_err_wsl, down_sn->mm,
+                sn->compute_profile_next(mm->flow, min_err_wsl, mm, down_mm,
                                          bbopt);
-                sn->mm->ws_err = actual_err;
-                sn->mm->k_err =
-                    sn->mm->flow - sn->mm->k_total * std::sqrt(sn->mm->sf);
+                mm->ws_err = actual_err;
+                mm->k_err =
+                    mm->flow - mm->k_total * std::sqrt(mm->sf);
 
-                if (min_err < 0.1 && sn->mm->froude <= bbopt->froude_threshold) {
+                if (min_err < 0.1 && mm->froude <= bbopt->froude_threshold) {
                   // keeping the min err result
                   if (!bbopt->silent_run) {
                     std::cout << "setting to min error result on streamnode "
@@ -1436,32 +2554,33 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                   }
                   // optimization
 
-                  double initguess = sn->mm->min_elev + down_sn->mm->depth_critical;
-                  if (down_sn->mm->depth_critical <= 0) {
+                  double initguess = mm->min_elev + down_mm->depth_critical;
+                  if (down_mm->depth_critical <= 0) {
                     // if downstream critical depth is not available or <= 0, use downstream depth as initial guess instead
-                    initguess = sn->mm->min_elev + down_sn->mm->depth;
+                    initguess = mm->min_elev + down_mm->depth;
                   }
 
                   double wsl_critical = brent_minimize(
-                      sn->mm->min_elev+0.001,
-                      sn->mm->min_elev + sn->depthdf->back()->depth, 
+                      mm->min_elev+0.001,
+                      mm->min_elev + sn->depthdf->back()->depth, 
                       initguess, // initial guess based on downstream depth_critical
                       [&](double x) {
-                        auto temp_sn = std::make_unique<CStreamnode>(*sn);
-                        return temp_sn->get_total_energy(x, down_sn->mm, bbopt);
+                        tm.energy_evals++;
+                        return sn->evaluate_total_energy(x, mm->flow, down_mm, bbopt);
                       });
 
-                  if (wsl_critical >= sn->mm->min_elev &&
+                  if (wsl_critical >= mm->min_elev &&
                       wsl_critical <=
                           sn->depthdf->back()->depth) { // if optimization worked
-                    double depth_critical = wsl_critical - sn->mm->min_elev;
-                    sn->mm->depth_critical = depth_critical;
+                    double depth_critical = wsl_critical - mm->min_elev;
+                    mm->depth_critical = depth_critical;
                     sn->compute_profile_next(
-                        sn->mm->flow, sn->mm->min_elev + sn->mm->depth_critical,
-                        down_sn->mm, bbopt);
-                    sn->mm->ws_err = PLACEHOLDER;
-                    sn->mm->k_err =
-                        sn->mm->flow - sn->mm->k_total * std::sqrt(sn->mm->sf);
+                        mm->flow, mm->min_elev + mm->depth_critical,
+                        mm, down_mm, bbopt);
+                    mm->ws_err = PLACEHOLDER;
+                    mm->k_err =
+                        mm->flow - mm->k_total * std::sqrt(mm->sf);
+                    tm.critical_fallbacks++;
                     if (!bbopt->silent_run) {
                       std::cout << "setting to critical depth result on streamnode "
                                 << std::to_string(sn->nodeID) << std::endl;
@@ -1480,13 +2599,13 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
 
               if (i == 0) {
                 // setting based on second trial rules
-                double proposed_wsl = sn->mm->wsl + 0.7 * err_lag1;
-                if (std::abs(proposed_wsl - sn->mm->wsl) > max_depth_change) {
-                  sn->mm->wsl =
-                      sn->mm->wsl +
-                      std::copysign(max_depth_change, proposed_wsl - sn->mm->wsl);
+                double proposed_wsl = mm->wsl + 0.7 * err_lag1;
+                if (std::abs(proposed_wsl - mm->wsl) > max_depth_change) {
+                  mm->wsl =
+                      mm->wsl +
+                      std::copysign(max_depth_change, proposed_wsl - mm->wsl);
                 } else {
-                  sn->mm->wsl = proposed_wsl;
+                  mm->wsl = proposed_wsl;
                 }
               } else {
                 if (std::abs(err_diff) < 0.03 ||
@@ -1500,13 +2619,14 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                     }
 
                     using_exhaustive = true;
-                    ExhaustiveWSLResult res = solve_wsl_exhaustive(sn, down_sn);
+                    tm.path = enum_solver_path::PATH_SECANT_TO_EXHAUSTIVE;
+                    ExhaustiveWSLResult res = solve_wsl_exhaustive(sn, down_sn, mm, down_mm, tm);
 
                     // store results
-                    sn->mm->wsl            = res.wsl_estimated;
-                    sn->mm->depth_critical = res.wsl_critical - sn->mm->min_elev;
-                    sn->mm->depth          = sn->mm->wsl - sn->mm->min_elev;
-                    sn->compute_profile_next(sn->mm->flow, sn->mm->wsl, down_sn->mm, bbopt);
+                    mm->wsl            = res.wsl_estimated;
+                    mm->depth_critical = res.wsl_critical - mm->min_elev;
+                    mm->depth          = mm->wsl - mm->min_elev;
+                    sn->compute_profile_next(mm->flow, mm->wsl, mm, down_mm, bbopt);
 
                   } else {
                     // for small error differences, secant method can fail
@@ -1519,23 +2639,23 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                           prevWSL_lag1 + std::copysign(0.5 * max_depth_change,
                                                        comp_wsl - prevWSL_lag1);
                     }
-                    sn->mm->wsl = proposed_wsl;
+                    mm->wsl = proposed_wsl;
                   }
                 } else {
                   // secant method
                   double proposed_wsl =
                       prevWSL_lag2 - err_lag2 * assum_diff / err_diff;
-                  if (std::abs(proposed_wsl - sn->mm->wsl) > max_depth_change) {
-                    sn->mm->wsl =
-                        sn->mm->wsl +
-                        std::copysign(max_depth_change, proposed_wsl - sn->mm->wsl);
+                  if (std::abs(proposed_wsl - mm->wsl) > max_depth_change) {
+                    mm->wsl =
+                        mm->wsl +
+                        std::copysign(max_depth_change, proposed_wsl - mm->wsl);
                   } else {
-                    sn->mm->wsl = proposed_wsl;
+                    mm->wsl = proposed_wsl;
                   }
                 }
               }
             } else {
-              if (sn->mm->froude <= bbopt->froude_threshold || using_exhaustive) {
+              if (mm->froude <= bbopt->froude_threshold || using_exhaustive) {
                 if (!bbopt->silent_run) {
                   std::cout << "Iterated on WSL at streamnode "
                             << std::to_string(sn->nodeID)
@@ -1547,31 +2667,32 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                   std::cout << "need to check crit depth" << std::endl;
                 }
 
-                double initguess = sn->mm->min_elev + down_sn->mm->depth_critical;
-                  if (down_sn->mm->depth_critical <= 0) {
+                double initguess = mm->min_elev + down_mm->depth_critical;
+                  if (down_mm->depth_critical <= 0) {
                     // if downstream critical depth is not available or <= 0, use downstream depth as initial guess instead
-                    initguess = sn->mm->min_elev + down_sn->mm->depth;
+                    initguess = mm->min_elev + down_mm->depth;
                   }
 
                 double wsl_critical = brent_minimize(
-                    sn->mm->min_elev+0.001, 
-                    sn->mm->min_elev + sn->depthdf->back()->depth,
+                    mm->min_elev+0.001, 
+                    mm->min_elev + sn->depthdf->back()->depth,
                     initguess, // initial guess based on downstream depth_critical
                     [&](double x) {
-                      auto temp_sn = std::make_unique<CStreamnode>(*sn);
-                      return temp_sn->get_total_energy(x, down_sn->mm, bbopt);
+                      tm.energy_evals++;
+                      return sn->evaluate_total_energy(x, mm->flow, down_mm, bbopt);
                     });
 
-                if (wsl_critical >= sn->mm->min_elev &&
+                if (wsl_critical >= mm->min_elev &&
                     wsl_critical <=
                         sn->depthdf->back()->depth) { // if optimization worked
-                  double depth_critical = wsl_critical - sn->mm->min_elev;
-                  sn->mm->depth_critical = depth_critical;
-                  if (sn->mm->depth < sn->mm->depth_critical) {
+                  double depth_critical = wsl_critical - mm->min_elev;
+                  mm->depth_critical = depth_critical;
+                  if (mm->depth < mm->depth_critical) {
                     if (found_supercritical) {
                       sn->compute_profile_next(
-                          sn->mm->flow, sn->mm->min_elev + sn->mm->depth_critical,
-                          down_sn->mm, bbopt);
+                          mm->flow, mm->min_elev + mm->depth_critical,
+                          mm, down_mm, bbopt);
+                      tm.critical_fallbacks++;
                       if (!bbopt->silent_run) {
                         std::cout << "setting to supercritical" << std::endl;
                       }
@@ -1581,16 +2702,16 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                         std::cout << "first time with supercritical, resetting"
                                   << std::endl;
                       }
-                      sn->compute_profile_next(sn->mm->flow,
-                                               sn->mm->min_elev +
-                                                   sn->mm->depth_critical + 1,
-                                               down_sn->mm, bbopt);
+                      sn->compute_profile_next(mm->flow,
+                                               mm->min_elev +
+                                                   mm->depth_critical + 1,
+                                               mm, down_mm, bbopt);
                       i = 0;
                       min_err = PLACEHOLDER;
                     }
                     found_supercritical = true;
                   } else {
-                    if (sn->mm->froude > 1) {
+                    if (mm->froude > 1) {
                       WriteWarning("Depth found to not be supercritical even "
                                    "though Froude is >1 at streamnode " +
                                        sn->nodeID,
@@ -1616,13 +2737,14 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
                           << std::to_string(sn->nodeID) << std::endl;
             }
             using_exhaustive = true;
-            ExhaustiveWSLResult res = solve_wsl_exhaustive(sn, down_sn);
+            tm.path = enum_solver_path::PATH_EXHAUSTIVE;
+            ExhaustiveWSLResult res = solve_wsl_exhaustive(sn, down_sn, mm, down_mm, tm);
 
             // store results
-            sn->mm->wsl            = res.wsl_estimated;
-            sn->mm->depth_critical = res.wsl_critical - sn->mm->min_elev;
-            sn->mm->depth          = sn->mm->wsl - sn->mm->min_elev;
-            sn->compute_profile_next(sn->mm->flow, sn->mm->wsl, down_sn->mm, bbopt);
+            mm->wsl            = res.wsl_estimated;
+            mm->depth_critical = res.wsl_critical - mm->min_elev;
+            mm->depth          = mm->wsl - mm->min_elev;
+            sn->compute_profile_next(mm->flow, mm->wsl, mm, down_mm, bbopt);
         } else {
         ExitGracefully(
             "Model.cpp: compute_streamnode: error in solver method input type",
@@ -1634,80 +2756,92 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
       int out_index = flow * bbsn->size() + ind;
 
       if ((*res)[out_index] == nullptr) {
-        (*res)[out_index] = new hydraulic_output(*(sn->mm));
+        (*res)[out_index] = new hydraulic_output(*(mm));
       } else {
-        *(*res)[out_index] = *(sn->mm);
+        *(*res)[out_index] = *(mm);
       }
 
-      sn->output_depths[flow] = sn->mm->depth;
-      sn->output_wsls[flow] = sn->mm->wsl;
+      sn->output_depths[flow] = mm->depth;
+      sn->output_wsls[flow] = mm->wsl;
     }
   }
 
   // check that results are within the Hseq bounds
   // with updated Brent method, depth will be restricted to upper bound already
   if (sn->nodetype == enum_nodetype::REACH) {
-    if (!sn->depthdf->empty() && sn->mm->depth > sn->depthdf->back()->depth) {
+    if (!sn->depthdf->empty() && mm->depth > sn->depthdf->back()->depth) {
       WriteWarning("Model.cpp: compute_streamnode: Results for flow of " +
                        std::to_string(flow) + " at streamnode " +
                        std::to_string(sn->nodeID) + " estimated a depth " +
-                       std::to_string(sn->mm->depth) +
+                       std::to_string(mm->depth) +
                        " beyond those provided for pre-processing;\nResults "
                        "should be re-run with a broader set of depths",
                    bbopt->noisy_run);
     }
   } else {
-    if (sn->mm->wsl > ((CXSection*)sn)->zz.max() ) {
+    if (mm->wsl > ((CXSection*)sn)->zz.max() ) {
       WriteWarning("Model.cpp: compute_streamnode: Results for flow of " +
                        std::to_string(flow) + " at streamnode " +
                        std::to_string(sn->nodeID) +
                        " estimated a water surface level " +
-                       std::to_string(sn->mm->wsl) +
+                       std::to_string(mm->wsl) +
                        " exceeding the zz value;\nResults should be re-run "
                        "with extended cross sections",
                    bbopt->noisy_run);
     }
   }
 
-  if (sn->mm->flow <= FLOW_TOL ||
-    sn->mm->area <= 0.0 ||
-    sn->mm->length_effectiveadjusted <= 0.0) {
+  if (mm->flow <= FLOW_TOL ||
+    mm->area <= 0.0 ||
+    mm->length_effectiveadjusted <= 0.0) {
 
-    sn->mm->peak_hrs_required = 0.0;
+    mm->peak_hrs_required = 0.0;
 
-    (*res)[flow * bbsn->size() + ind] = new hydraulic_output(*(sn->mm));
-    sn->output_depths[flow] = sn->mm->depth;
-    sn->output_wsls[flow] = sn->mm->wsl;
+    int out_index = flow * bbsn->size() + ind;
+    if ((*res)[out_index] == nullptr) {
+      (*res)[out_index] = new hydraulic_output(*(mm));
+    } else {
+      *(*res)[out_index] = *(mm);
+    }
+    sn->output_depths[flow] = mm->depth;
+    sn->output_wsls[flow] = mm->wsl;
 
+    record_telemetry();
     return;
   }
 
   // compute peak hours required and update min and max accordingly
-  sn->mm->peak_hrs_required = (sn->mm->area * sn->mm->length_effectiveadjusted / sn->mm->flow) / 3600;
-  if (peak_hrs_min == PLACEHOLDER || sn->mm->peak_hrs_required < peak_hrs_min) {
-    peak_hrs_min = sn->mm->peak_hrs_required;
+  mm->peak_hrs_required = (mm->area * mm->length_effectiveadjusted / mm->flow) / 3600;
+  std::unique_lock<std::mutex> peak_lock(ws.peak_hrs_mutex);
+  if (ws.peak_hrs_min == PLACEHOLDER || mm->peak_hrs_required < ws.peak_hrs_min) {
+    ws.peak_hrs_min = mm->peak_hrs_required;
   }
-  if (peak_hrs_max == PLACEHOLDER || sn->mm->peak_hrs_required > peak_hrs_max) {
-    peak_hrs_max = sn->mm->peak_hrs_required;
+  if (ws.peak_hrs_max == PLACEHOLDER || mm->peak_hrs_required > ws.peak_hrs_max) {
+    ws.peak_hrs_max = mm->peak_hrs_required;
   }
+  peak_lock.unlock();
 
-  // assign output to its designated location
+  // assign output to its designated location, reusing the prior output of an incremental solve
   int out_index = flow * bbsn->size() + ind;
-  (*res)[out_index] = new hydraulic_output(*(sn->mm));
-  sn->output_depths[flow] = sn->mm->depth;
-  sn->output_wsls[flow] = sn->mm->wsl;
+  if ((*res)[out_index] == nullptr) {
+    (*res)[out_index] = new hydraulic_output(*(mm));
+  } else {
+    *(*res)[out_index] = *(mm);
+  }
+  sn->output_depths[flow] = mm->depth;
+  sn->output_wsls[flow] = mm->wsl;
 
 
   //if (bbopt->debug_mode) {
-  //  std::cout << "Streamnode: " << to_string(sn->mm->nodeID)
-  //            << " depth: " << to_string(sn->mm->depth)
-  //            << " WSL: " << to_string(sn->mm->wsl)
-  //            << " min_elev: " << to_string(sn->mm->min_elev) 
-  //            << " area: " << to_string(sn->mm->area)
-  //            << " velocity:" << to_string(sn->mm->velocity)
-  //            << " flow: " << to_string(sn->mm->flow)
-  //            << " sf: " << to_string(sn->mm->sf)
-  //            << " Fr: " << to_string(sn->mm->froude)
+  //  std::cout << "Streamnode: " << to_string(mm->nodeID)
+  //            << " depth: " << to_string(mm->depth)
+  //            << " WSL: " << to_string(mm->wsl)
+  //            << " min_elev: " << to_string(mm->min_elev) 
+  //            << " area: " << to_string(mm->area)
+  //            << " velocity:" << to_string(mm->velocity)
+  //            << " flow: " << to_string(mm->flow)
+  //            << " sf: " << to_string(mm->sf)
+  //            << " Fr: " << to_string(mm->froude)
   //            << std::endl;
   //}
 
@@ -1735,107 +2869,121 @@ void CModel::compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::ve
   */
 
   // basic checks for instabilities
-  if (sn->mm->alpha != PLACEHOLDER && sn->mm->alpha > 5) {
+  if (mm->alpha != PLACEHOLDER && mm->alpha > 5) {
     WriteWarning("alpha value greater than 5 found, indicating possible instability in results. Please review.", bbopt->noisy_run);
   }
-  if (sn->mm->velocity != PLACEHOLDER && sn->mm->velocity > 50) {
+  if (mm->velocity != PLACEHOLDER && mm->velocity > 50) {
     WriteWarning("velocity value greater than 50 m/s found, indicating possible instability in results. Please review.", bbopt->noisy_run);
   }
-  if (sn->mm->sf_avg != PLACEHOLDER && sn->mm->sf_avg > 1) {
+  if (mm->sf_avg != PLACEHOLDER && mm->sf_avg > 1) {
     WriteWarning("Average friction slope value greater than 1 found, indicating possible instability in results. Please review.", bbopt->noisy_run);
   }
-  if (sn->mm->cp_iterations != PLACEHOLDER && sn->mm->cp_iterations > bbopt->iteration_limit_cp) {
+  if (mm->cp_iterations != PLACEHOLDER && mm->cp_iterations > bbopt->iteration_limit_cp) {
     WriteWarning("Iteration limit hit at streamnode " + std::to_string(sn->nodeID) + ", consider increasing bbopt->iteration_limit_cp", bbopt->noisy_run);
   }
+
+  record_telemetry();
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Solver for estimated and critical wsl using exhaustive search over the rows of the depth table
+/// \note the rows are processed in fixed size blocks; the arithmetic for each block is a branch-free
+/// loop over contiguous hydtable columns into stack buffers, followed by a single fused scan that
+/// tracks the minimum depth error and minimum energy. No heap allocation is performed
+/// \param sn_up [in] streamnode for which to compute hydraulic profile
+/// \param sn_down [in] streamnode one node downstream of sn
+/// \param mm_up [in/out] working state of sn_up
+/// \param mm_down [in] working state of sn_down
+/// \param tm [in/out] telemetry of the solve, counting residual and energy evaluations and critical depth fallbacks
+/// \return critical and estimated water surface levels at sn_up
+//
 ExhaustiveWSLResult CModel::solve_wsl_exhaustive(
     const CStreamnode* sn_up,
-    const CStreamnode* sn_down
+    const CStreamnode* sn_down,
+    hydraulic_output* mm_up,
+    const hydraulic_output* mm_down,
+    solver_telemetry& tm
 )
 {
-    const std::size_t n = sn_up->depthdf->size();
-    std::vector<double> depthsv(n);
-    std::vector<double> velocities(n);
-    std::vector<double> velheads(n);
-    std::vector<double> energies(n);
-    std::vector<double> sf(n);
-    std::vector<double> sfbar(n);
-    std::vector<double> losscoeff(n);
-    std::vector<double> headloss(n);
-    std::vector<double> deptherr(n);
-    std::vector<double> fr(n);
-    
-    for (std::size_t i = 0; i < n; ++i) {
-        hydraulic_output* row = (*sn_up->depthdf)[i];
-
-        depthsv[i] = row->depth;
-        velocities[i] = std::max(sn_up->mm->flow / row->area, 0.0);
-        velheads[i] = velocities[i] * velocities[i] / (2.0 * GRAVITY) * row->alpha;
-        energies[i] = sn_up->mm->min_elev + depthsv[i] + velheads[i];
-        sf[i]    = std::pow(sn_up->mm->flow / row->k_total, 2.0);
-        sfbar[i] = (sf[i] + sn_down->mm->sf) / 2.0;
-        losscoeff[i] = sn_up->expansion_coeff;
-        if (sn_down->mm->velocity_head > velheads[i]) {
-            losscoeff[i] = sn_up->contraction_coeff;
+    const hydraulic_table& t = sn_up->hydtable;
+    const int n = (int)t.depth.size();
+    ExitGracefullyIf(n == 0,
+                     "Model.cpp: solve_wsl_exhaustive: depth table is empty",
+                     BAD_DATA);
+    const double* depth = t.depth.data();
+    const double* area  = t.area.data();
+    const double* alpha = t.alpha.data();
+    const double* k     = t.k_total.data();
+    const double* leff  = t.length_effective.data();
+
+    const double Q         = mm_up->flow;
+    const double bed       = mm_up->min_elev;
+    const double cc        = sn_up->contraction_coeff;
+    const double ec        = sn_up->expansion_coeff;
+    const double sf_down   = mm_down->sf;
+    const double vh_down   = mm_down->velocity_head;
+    const double d_down    = mm_down->depth;
+    const double bed_down  = mm_down->min_elev;
+
+    constexpr int BLOCK = 64;
+    double deptherr[BLOCK];
+    double energies[BLOCK];
+
+    int index_solved = -1, index_crit = -1;
+    double min_err = 0.0, min_E = 0.0;
+    for (int b0 = 0; b0 < n; b0 += BLOCK) {
+        const int m = std::min(BLOCK, n - b0);
+
+        // arithmetic kernel, no branches so that the compiler can vectorize it
+        for (int j = 0; j < m; ++j) {
+            const int i = b0 + j;
+            double velocity = std::max(Q / area[i], 0.0);
+            double velhead  = velocity * velocity / (2.0 * GRAVITY) * alpha[i];
+            double sf       = (Q / k[i]) * (Q / k[i]);
+            double sfbar    = (sf + sf_down) / 2.0;
+            double losscoeff = vh_down > velhead ? cc : ec;
+            double headloss = leff[i] * sfbar + losscoeff * std::abs(velhead - vh_down);
+            energies[j] = bed + depth[i] + velhead;
+            deptherr[j] = std::abs(depth[i] + bed - d_down - bed_down - vh_down - headloss + velhead);
+        }
+
+        // fused min-reduction, first minimum wins and NaN is never preferred (as std::min_element with nan_less)
+        for (int j = 0; j < m; ++j) {
+            if (index_solved < 0 || nan_less(deptherr[j], min_err)) {
+                min_err = deptherr[j];
+                index_solved = b0 + j;
+            }
+            if (index_crit < 0 || nan_less(energies[j], min_E)) {
+                min_E = energies[j];
+                index_crit = b0 + j;
+            }
         }
-        headloss[i] =
-            row->length_effective * sfbar[i] +
-            losscoeff[i] * std::abs(velheads[i] - sn_down->mm->velocity_head);
-        fr[i] = velocities[i] / std::sqrt(GRAVITY * depthsv[i]);
-        deptherr[i] = std::abs(
-            depthsv[i] + row->min_elev
-            - sn_down->mm->depth
-            - sn_down->mm->min_elev
-            - sn_down->mm->velocity_head
-            - headloss[i]
-            + velheads[i]
-        );
     }
 
+    // every row is evaluated for both depth error and energy
+    tm.residual_evals += n;
+    tm.energy_evals += n;
+
     // depth with minimum depth error -> "solved" depth
-    auto it = std::min_element(
-        deptherr.begin(), deptherr.end(),
-        [](double a, double b) {
-            if (std::isnan(a)) return false;
-            if (std::isnan(b)) return true;
-            return a < b;
-        }
-    );
-    std::size_t index_solved = std::distance(deptherr.begin(), it);
-    double solveddepth   = depthsv[index_solved];
-    double solvedfroude  = fr[index_solved];
+    double solveddepth  = depth[index_solved];
+    double solvedfroude = std::max(Q / area[index_solved], 0.0) / std::sqrt(GRAVITY * solveddepth);
 
     // depth with minimum energy -> critical depth
-    auto itE = std::min_element(
-        energies.begin(), energies.end(),
-        [](double a, double b) {
-            if (std::isnan(a)) return false;
-            if (std::isnan(b)) return true;
-            return a < b;
-        }
-    );
-    std::size_t index_crit = std::distance(energies.begin(), itE);
-    double critdepth = depthsv[index_crit];
+    double critdepth = depth[index_crit];
 
     if (solvedfroude >= bbopt->froude_threshold) {
-        sn_up->mm->wsl = sn_up->mm->min_elev + solveddepth;
+        mm_up->wsl = mm_up->min_elev + solveddepth;
     } else {
-        sn_up->mm->wsl = sn_up->mm->min_elev + critdepth;
+        mm_up->wsl = mm_up->min_elev + critdepth;
+        tm.critical_fallbacks++;
     }
-    sn_up->mm->depth_critical = critdepth;
+    mm_up->depth_critical = critdepth;
 
-    double wsl_critical  = sn_up->mm->min_elev + critdepth;
-    double wsl_estimated = sn_up->mm->min_elev +
+    double wsl_critical  = mm_up->min_elev + critdepth;
+    double wsl_estimated = mm_up->min_elev +
                            ((solvedfroude >= bbopt->froude_threshold)
                                 ? solveddepth
                                 : critdepth);
-    /*
-    std::cout << "Exhaustive WSL solver results for streamnode " << sn_up->nodeID << ": "
-              << "wsl_critical = " << wsl_critical << ", "
-              << "wsl_estimated = " << wsl_estimated 
-        << "depth = " << wsl_estimated-sn_up->min_elev << std::endl;
-    */
 
     return ExhaustiveWSLResult{ wsl_critical, wsl_estimated };
 }
@@ -1849,25 +2997,24 @@ ExhaustiveWSLResult CModel::solve_wsl_exhaustive(
 //
 double CModel::solve_critical_wsl_brent(
     const CStreamnode* sn_up, 
-    const CStreamnode* sn_down
+    const CStreamnode* sn_down,
+    const hydraulic_output* mm_up,
+    const hydraulic_output* mm_down
 )
 {
-    const double bed = sn_up->mm->min_elev;
+    const double bed = mm_up->min_elev;
 
     // Initial guess: downstream critical depth if available
-    double initguess = bed + sn_down->mm->depth_critical;
-    if (sn_down->mm->depth_critical <= 0.0) {
-        initguess = bed + sn_down->mm->depth;   // fallback to downstream depth
+    double initguess = bed + mm_down->depth_critical;
+    if (mm_down->depth_critical <= 0.0) {
+        initguess = bed + mm_down->depth;   // fallback to downstream depth
     }
 
-    // Numerical derivative of total energy: dE/dH = 0 at critical depth
+    // Analytic derivative of total energy: dE/dH = 0 at critical depth
     auto dEdx = [&](double H) {
-        const double h = 1e-4;
-        auto s1 = std::make_unique<CStreamnode>(*sn_up);
-        auto s2 = std::make_unique<CStreamnode>(*sn_up);
-        double Eplus  = s1->get_total_energy(H + h, sn_down->mm, bbopt);
-        double Eminus = s2->get_total_energy(H - h, sn_down->mm, bbopt);
-        return (Eplus - Eminus) / (2.0 * h);
+        double dEdH = 0.0;
+        sn_up->evaluate_total_energy(H, mm_up->flow, mm_down, bbopt, dEdH);
+        return dEdH;
     };
 
     // Bounds for root search
@@ -1886,15 +3033,19 @@ double CModel::solve_critical_wsl_brent(
 /// \note used in the compute_streamnode for BRENT method
 /// \param sn_up [in] streamnode for which to compute hydraulic profile
 /// \param sn_down [in] streamnode one node downstream of sn
+/// \param mm_up [in] working state of sn_up
+/// \param mm_down [in] working state of sn_down
 /// \output wsl_critical [out] estimated water surface level at sn_up that satisfies energy balance with sn_down
 //
 double CModel::solve_critical_wsl_brent_analytical(
     const CStreamnode* sn_up,
-    const CStreamnode* sn_down
+    const CStreamnode* sn_down,
+    const hydraulic_output* mm_up,
+    const hydraulic_output* mm_down
 )
 {
-    const double bed = sn_up->mm->min_elev;
-    const double Q   = sn_up->mm->flow;
+    const double bed = mm_up->min_elev;
+    const double Q   = mm_up->flow;
 
     // ---------------------------------------------------------
     // Derivative of specific energy with respect to DEPTH
@@ -1951,55 +3102,46 @@ double CModel::solve_critical_wsl_brent_analytical(
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Solver for critical depth using iterative exhaustive search
-/// \note used in the compute_streamnode for BRENT method
-/// \param sn_up [in] streamnode for which to compute hydraulic profile
-/// \param sn_down [in] streamnode one node downstream of sn
-/// \output wsl_critical [out] estimated water surface level at sn_up that satisfies energy balance with sn_down
+/// \brief Critical depth using iterative exhaustive search over a depth table
+/// \note depends only on the table and flow, used in solve_critical_wsl_exhaustive and to fill critical_depth_curve
+/// \param t [in] preprocessed depth table of the streamnode
+/// \param Q [in] flow at the streamnode
+/// \param energy_evals [in/out] incremented by the number of specific energy evaluations used
+/// \return critical depth at the streamnode
 //
-double CModel::solve_critical_wsl_exhaustive(
-    const CStreamnode* sn_up,
-    const CStreamnode* sn_down
-)
+double critical_depth_exhaustive(const hydraulic_table& t, double Q, long& energy_evals)
 {
-    const double bed = sn_up->mm->min_elev;
-    const double Q   = sn_up->mm->flow;
-
-    const auto& df = *sn_up->depthdf;   // preprocessed depth table
-    if (df.empty())
-        return bed + 0.1;
+    const int n = (int)t.depth.size();
+    if (n == 0)
+        return 0.1;
 
     // ---------------------------------------------------------
-    // Specific energy function E(depth)
+    // Specific energy E = y + alpha v^2 / (2g) from area and alpha at depth
     // ---------------------------------------------------------
-    auto E = [&](double depth)
+    auto E = [&](double depth, double A, double alpha)
     {
+        energy_evals++;
         if (depth <= 0.0)
             return std::numeric_limits<double>::infinity();
-
-        double A     = sn_up->get_area(depth);
-        // double Tw    = sn_up->get_topwidth(depth);
-        double alpha = sn_up->get_alpha(depth);
         double v  = Q / A;
         double ke = alpha * v * v / (2.0 * GRAVITY);
-        return depth + ke;   // E = y + α v² / (2g)
+        return depth + ke;
     };
 
     // ---------------------------------------------------------
-    // Step 1: Find first local minimum in depthdf
+    // Step 1: Find first local minimum over the table rows, read directly from the columns
     // ---------------------------------------------------------
-    double best_depth = df.front()->depth;
-    double best_E     = E(best_depth);
+    double best_depth = t.depth[0];
+    double best_E     = E(t.depth[0], t.area[0], t.alpha[0]);
 
-    for (size_t i = 1; i < df.size(); ++i)
+    for (int i = 1; i < n; ++i)
     {
-        double d  = df[i]->depth;
-        double Ei = E(d);
+        double Ei = E(t.depth[i], t.area[i], t.alpha[i]);
 
         if (Ei < best_E)
         {
             best_E     = Ei;
-            best_depth = d;
+            best_depth = t.depth[i];
         }
         else
         {
@@ -2008,136 +3150,131 @@ double CModel::solve_critical_wsl_exhaustive(
         }
     }
 
-    // ---------------------------------------------------------
-    // Step 2: Manual refinement around the minimum
-    // ---------------------------------------------------------
-    double refine_step = 0.01;   // 1 cm refinement
-    double search_lo   = std::max(0.001, best_depth - 0.20);
-    double search_hi   = best_depth + 0.20;
+    // ---------------------------------------------------------
+    // Step 2: Manual refinement around the minimum, one table bracket per candidate depth
+    // ---------------------------------------------------------
+    double refine_step = 0.01;   // 1 cm refinement
+    double search_lo   = std::max(0.001, best_depth - 0.20);
+    double search_hi   = best_depth + 0.20;
+
+    for (double depth = search_lo; depth <= search_hi; depth += refine_step)
+    {
+        table_bracket b = find_table_bracket_depth(depth, t);
+        double Ei = E(depth,
+                      interpolate_depth(b, &hydraulic_table::area, t),
+                      interpolate_depth(b, &hydraulic_table::alpha, t));
+        if (Ei < best_E)
+        {
+            best_E     = Ei;
+            best_depth = depth;
+        }
+    }
+
+    return std::max(best_depth, 0.03); // prevent zero critical depth
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Solver for critical depth using iterative exhaustive search
+/// \note used in the compute_streamnode for BRENT method
+/// \param sn_up [in] streamnode for which to compute hydraulic profile
+/// \param sn_down [in] streamnode one node downstream of sn
+/// \param mm_up [in] working state of sn_up
+/// \param mm_down [in] working state of sn_down
+/// \param tm [in/out] telemetry of the solve, counting energy evaluations
+/// \output wsl_critical [out] estimated water surface level at sn_up that satisfies energy balance with sn_down
+//
+double CModel::solve_critical_wsl_exhaustive(
+    const CStreamnode* sn_up,
+    const CStreamnode* sn_down,
+    const hydraulic_output* mm_up,
+    const hydraulic_output* mm_down,
+    solver_telemetry& tm
+)
+{
+    return mm_up->min_elev + critical_depth_exhaustive(sn_up->hydtable, mm_up->flow, tm.energy_evals);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Critical wsl interpolated in log flow between the bounding rungs of the flow ladder of sn_up
+/// \note rungs are computed with critical_depth_exhaustive on first use and kept in crit_curves. If the
+/// critical depth changes by more than bbopt->critical_depth_cache_tol across the bounding rungs, the
+/// critical depth is recomputed exactly instead
+/// \param ind [in] index in bbsn of sn_up
+/// \param sn_up [in] streamnode for which to compute hydraulic profile
+/// \param mm_up [in] working state of sn_up
+/// \param ws [in/out] working state of the flow profile, used to count cached and exact critical depths
+/// \param tm [in/out] telemetry of the solve, counting energy evaluations
+/// \output wsl_critical [out] critical water surface level at sn_up
+//
+double CModel::solve_critical_wsl_cached(int ind, const CStreamnode* sn_up, const hydraulic_output* mm_up, profile_workspace &ws, solver_telemetry &tm)
+{
+    const double Q = mm_up->flow;
+    if (Q <= 0.0) {
+        ws.num_crit_exact++;
+        return mm_up->min_elev + critical_depth_exhaustive(sn_up->hydtable, Q, tm.energy_evals);
+    }
 
-    for (double depth = search_lo; depth <= search_hi; depth += refine_step)
-    {
-        double Ei = E(depth);
-        if (Ei < best_E)
-        {
-            best_E     = Ei;
-            best_depth = depth;
+    const double log_ratio = std::log(CRIT_LADDER_RATIO);
+    const int k = (int)std::floor(std::log(Q / CRIT_LADDER_BASE_FLOW) / log_ratio);
+    const double Q_lo = CRIT_LADDER_BASE_FLOW * std::exp(k * log_ratio);
+
+    // critical depths at the bounding rungs, computed outside of the lock if missing
+    critical_depth_curve &curve = crit_curves[ind];
+    double yc[2];
+    for (int r = 0; r < 2; r++) {
+        std::unique_lock<std::mutex> lock(curve.mutex);
+        auto it = curve.rungs.find(k + r);
+        if (it != curve.rungs.end()) {
+            yc[r] = it->second;
+            continue;
         }
+        lock.unlock();
+        yc[r] = critical_depth_exhaustive(sn_up->hydtable, Q_lo * (r == 0 ? 1.0 : CRIT_LADDER_RATIO), tm.energy_evals);
+        lock.lock();
+        curve.rungs[k + r] = yc[r];
     }
 
-    // ---------------------------------------------------------
-    // Final critical depth → convert to WSL
-    // ---------------------------------------------------------
-    double depth_critical = std::max(best_depth, 0.03); // prevent zero critical depth
-    double wsl_critical   = bed + depth_critical;
-
-    return wsl_critical;
+    if (std::abs(yc[1] - yc[0]) > bbopt->critical_depth_cache_tol) {
+        ws.num_crit_exact++;
+        return mm_up->min_elev + critical_depth_exhaustive(sn_up->hydtable, Q, tm.energy_evals);
+    }
+    ws.num_crit_cached++;
+    double w = std::min(std::max(std::log(Q / Q_lo) / log_ratio, 0.0), 1.0);
+    return mm_up->min_elev + yc[0] + w * (yc[1] - yc[0]);
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Linearly interpolates to get the cross-sectional area at a given
-/// water surface level H
-/// \note used in the CModel::solve_critical_wsl_brent_analytical
-/// \param H [in] water surface level to compute property for
-/// \output area [out] linearly interpolated cross-sectional area at water surface level H
+/// \brief Linearly interpolates to get the cross-sectional area at a given depth
+/// \note used in the CModel::solve_critical_wsl_brent_analytical and solve_critical_wsl_exhaustive
+/// \param depth [in] depth to compute property for
+/// \output area [out] linearly interpolated cross-sectional area at depth, clamped to the table range
 //
 double CStreamnode::get_area(double depth) const
 {
-    const auto& df = *depthdf;   
-
-    // Below lowest tabulated depth
-    if (depth <= df.front()->depth)
-        return df.front()->area;
-
-    // Above highest tabulated depth
-    if (depth >= df.back()->depth)
-        return df.back()->area;
-
-    // Linear interpolation
-    for (size_t i = 0; i < df.size() - 1; ++i)
-    {
-        const auto& d1 = df[i];
-        const auto& d2 = df[i+1];
-        if (depth >= d1->depth && depth <= d2->depth)
-        {
-            double t = (depth - d1->depth) / (d2->depth - d1->depth);
-            return d1->area + t * (d2->area - d1->area);
-        }
-    }
-    return df.back()->area; // fallback
+  return interpolate_depth(find_table_bracket_depth(depth, hydtable), &hydraulic_table::area, hydtable);
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Linearly interpolates to get the top width at a given
-/// water surface level H
+/// \brief Linearly interpolates to get the top width at a given depth
 /// \note used in the CModel::solve_critical_wsl_brent_analytical
-/// \param H [in] water surface level to compute property for
-/// \output area [out] linearly interpolated top width at water surface level H
+/// \param depth [in] depth to compute property for
+/// \output top_width [out] linearly interpolated top width at depth, clamped to the table range
 //
 double CStreamnode::get_topwidth(double depth) const
 {
-
-    // depthdf is a POINTER → dereference it once
-    const auto& df = *depthdf;   // df is now a reference to the vector
-
-    // Below lowest tabulated depth
-    if (depth <= df.front()->depth)
-        return df.front()->top_width;
-
-    // Above highest tabulated depth
-    if (depth >= df.back()->depth)
-        return df.back()->top_width;
-
-    // Linear interpolation
-    for (size_t i = 0; i < df.size() - 1; ++i)
-    {
-        const auto& d1 = df[i];
-        const auto& d2 = df[i+1];
-
-        if (depth >= d1->depth && depth <= d2->depth)
-        {
-            double t = (depth - d1->depth) / (d2->depth - d1->depth);
-            return d1->top_width + t * (d2->top_width - d1->top_width);
-        }
-    }
-
-    // Fallback (should never happen)
-    return df.back()->top_width;
+  return interpolate_depth(find_table_bracket_depth(depth, hydtable), &hydraulic_table::top_width, hydtable);
 }
 
 //////////////////////////////////////////////////////////////////
 /// \brief Linearly interpolates to get the velocity correction
-///        coefficient alpha at a given water surface level H
-/// \note  Same pattern as get_area(), used in critical‑depth calcs
-/// \param H [in] water surface level
-/// \return alpha [out] interpolated velocity‑correction coefficient
+///        coefficient alpha at a given depth
+/// \note  Same pattern as get_area(), used in critical-depth calcs
+/// \param depth [in] depth to compute property for
+/// \return alpha [out] interpolated velocity-correction coefficient, clamped to the table range
 //
 double CStreamnode::get_alpha(double depth) const
 {
-    const auto& df = *depthdf;
-
-    // Below lowest tabulated depth
-    if (depth <= df.front()->depth)
-        return df.front()->alpha;
-
-    // Above highest tabulated depth
-    if (depth >= df.back()->depth)
-        return df.back()->alpha;
-
-    // Linear interpolation
-    for (size_t i = 0; i < df.size() - 1; ++i)
-    {
-        const auto& d1 = df[i];
-        const auto& d2 = df[i+1];
-
-        if (depth >= d1->depth && depth <= d2->depth)
-        {
-            double t = (depth - d1->depth) / (d2->depth - d1->depth);
-            return d1->alpha + t * (d2->alpha - d1->alpha);
-        }
-    }
-
-    return df.back()->alpha; // fallback
+  return interpolate_depth(find_table_bracket_depth(depth, hydtable), &hydraulic_table::alpha, hydtable);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -2145,26 +3282,55 @@ double CStreamnode::get_alpha(double depth) const
 /// \note used in the compute_streamnode for BRENT method
 /// \param sn_up [in] streamnode for which to compute hydraulic profile
 /// \param sn_down [in] streamnode one node downstream of sn
+/// \param mm_up [in] working state of sn_up
+/// \param mm_down [in] working state of sn_down
 /// \param wsl_critical [in] critical water surface elevation at the sn_up node
+/// \param wsl_prior [in] prior water surface elevation at the sn_up node used to warm start the bracket, PLACEHOLDER if none
+/// \param tm [in/out] telemetry of the solve, counting residual evaluations, bracket expansions and critical depth fallbacks
 /// \output wsl_estimated [out] estimated water surface level at sn_up that satisfies energy balance with sn_down
 //
 double CModel::solve_wsl_standard_step_brent(
     const CStreamnode* sn_up,          // upstream node (solution at this node)
     const CStreamnode* sn_down,        // downstream node (known or target)
-    double wsl_critical                // critical water surface level at upstream
+    const hydraulic_output* mm_up,     // working state of upstream node
+    const hydraulic_output* mm_down,   // working state of downstream node
+    double wsl_critical,               // critical water surface level at upstream
+    double wsl_prior,                  // prior water surface level at upstream, PLACEHOLDER if none
+    solver_telemetry &tm               // telemetry of the solve
 )
 {
     // Residual wrapper: R(H) = energy_up(H) - energy_down_target
     auto residual = [&](double H) {
-        auto temp_sn = std::make_unique<CStreamnode>(*sn_up);
-        return temp_sn->get_wsl_residual(H, sn_down->mm, bbopt);
+        tm.residual_evals++;
+        return sn_up->evaluate_wsl_residual(H, mm_up->flow, mm_down, bbopt);
     };
 
     // Basic physical bounds
-    const double bed_elev = sn_up->mm->min_elev;
+    const double bed_elev = mm_up->min_elev;
     const double Hc       = wsl_critical;
     const double Htab_max = bed_elev + sn_up->depthdf->back()->depth;
 
+    // Warm start: try a tight bracket around the prior solution, widening it once before
+    // falling back to the full bracket below
+    if (wsl_prior != PLACEHOLDER) {
+        double half_width = bbopt->warm_start_window;
+        for (int i = 0; i < 2; ++i, half_width *= 4.0) {
+            if (i > 0) {
+                tm.bracket_expansions++;
+            }
+            double Lw = std::max(bed_elev + 1e-3, wsl_prior - half_width);
+            double Uw = std::min(Htab_max, wsl_prior + half_width);
+            if (Uw <= Lw) {
+                break;
+            }
+            double fLw = residual(Lw);
+            double fUw = residual(Uw);
+            if (fLw * fUw < 0.0) {
+                return brent_root2(Lw, Uw, residual, 1e-8, 100);
+            }
+        }
+    }
+
     // Start with a conservative search interval
     double L = bed_elev + 1e-3;  // set to bound from 0m+tol in case it is critical
     double U = Htab_max;
@@ -2204,6 +3370,7 @@ double CModel::solve_wsl_standard_step_brent(
     double       span            = base_span;
 
     for (int i = 0; i < max_expand_iter && fL * fU > 0.0; ++i) {
+        tm.bracket_expansions++;
 
         // Expand depending on monotonicity:
         // - If increasing (mono_sign > 0): root lies where residual crosses zero,
@@ -2255,6 +3422,7 @@ double CModel::solve_wsl_standard_step_brent(
     // No bracket found: hydraulically inconsistent or outside table.
     WriteWarning("WSL residual cannot be bracketed; falling back to critical or last valid depth",
                  bbopt->noisy_run);
+    tm.critical_fallbacks++;
 
     // Fallback strategy:
     // 1) If residual at critical is small, accept critical.
@@ -2285,6 +3453,102 @@ double CModel::solve_wsl_standard_step_brent(
     return best_H;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Safeguarded Newton WSL solver using the analytic derivative of the energy residual
+/// \note used in the compute_streamnode for NEWTON method. Each iterate that changes the sign of the
+/// residual tightens a bracket; once bracketed, Newton steps leaving the bracket or failing to halve
+/// the residual are replaced by bisection. Falls back to solve_wsl_standard_step_brent if no root is found
+/// \param sn_up [in] streamnode for which to compute hydraulic profile
+/// \param sn_down [in] streamnode one node downstream of sn
+/// \param mm_up [in] working state of sn_up, whose wsl is used as the initial guess without a prior
+/// \param mm_down [in] working state of sn_down
+/// \param wsl_critical [in] critical water surface elevation at the sn_up node
+/// \param wsl_prior [in] prior water surface elevation at the sn_up node used as the initial guess, PLACEHOLDER if none
+/// \param tm [in/out] telemetry of the solve, counting residual evaluations and recording a fallback to brent
+/// \output wsl_estimated [out] estimated water surface level at sn_up that satisfies energy balance with sn_down
+//
+double CModel::solve_wsl_standard_step_newton(
+    const CStreamnode* sn_up,
+    const CStreamnode* sn_down,
+    const hydraulic_output* mm_up,
+    const hydraulic_output* mm_down,
+    double wsl_critical,
+    double wsl_prior,
+    solver_telemetry &tm
+)
+{
+    static constexpr double NEWTON_TOL = 1e-8; // convergence tolerance (m) on the wsl step
+    static constexpr int NEWTON_MAX_ITER = 50;
+
+    auto residual = [&](double H, double &dRdH) {
+        tm.residual_evals++;
+        return sn_up->evaluate_wsl_residual(H, mm_up->flow, mm_down, bbopt, dRdH);
+    };
+
+    // Basic physical bounds, as in solve_wsl_standard_step_brent
+    const double L = mm_up->min_elev + 1e-3;
+    const double U = mm_up->min_elev + sn_up->depthdf->back()->depth;
+
+    double H = wsl_prior != PLACEHOLDER ? wsl_prior : mm_up->wsl;
+    H = std::min(std::max(H, L), U);
+
+    // ends of the bracket found so far, PLACEHOLDER until the residual has been seen with that sign
+    double H_neg = PLACEHOLDER, H_pos = PLACEHOLDER;
+    double dR = 0.0;
+    double R = residual(H, dR);
+    double R_prev = ALMOST_INF;
+
+    for (int i = 0; i < NEWTON_MAX_ITER; ++i) {
+        if (R == 0.0) {
+            return H;
+        }
+        if (R < 0.0) {
+            H_neg = H;
+        } else {
+            H_pos = H;
+        }
+        bool bracketed = H_neg != PLACEHOLDER && H_pos != PLACEHOLDER;
+        bool has_slope = dR != 0.0 && std::isfinite(dR);
+
+        double H_next = has_slope ? H - R / dR : PLACEHOLDER;
+        if (bracketed) {
+            double lo = std::min(H_neg, H_pos);
+            double hi = std::max(H_neg, H_pos);
+            if (!has_slope || H_next <= lo || H_next >= hi || std::abs(R) > 0.5 * std::abs(R_prev)) {
+                H_next = 0.5 * (lo + hi);
+            }
+        } else {
+            if (!has_slope) {
+                break;
+            }
+            H_next = std::min(std::max(H_next, L), U);
+            if (H_next == H) {
+                break; // pinned against a bound without a sign change
+            }
+        }
+
+        if (std::abs(H_next - H) <= NEWTON_TOL) {
+            return H_next;
+        }
+        H = H_next;
+        R_prev = R;
+        R = residual(H, dR);
+    }
+
+    // iteration limit reached within a bracket, finish with brent on the bracket
+    if (H_neg != PLACEHOLDER && H_pos != PLACEHOLDER) {
+        auto residual_only = [&](double H) {
+            tm.residual_evals++;
+            return sn_up->evaluate_wsl_residual(H, mm_up->flow, mm_down, bbopt);
+        };
+        return brent_root2(std::min(H_neg, H_pos), std::max(H_neg, H_pos), residual_only, 1e-8, 100);
+    }
+
+    // no bracket found by newton, fall back to the bracket search of the brent solver
+    tm.path = enum_solver_path::PATH_NEWTON_TO_BRENT;
+    return solve_wsl_standard_step_brent(sn_up, sn_down, mm_up, mm_down, wsl_critical, wsl_prior, tm);
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Finds dhand depths on either side of "depth"
 /// \param depth [in] depth to consider
@@ -2302,7 +3566,7 @@ std::pair<int, int> CModel::dhand_bounding_depths(double depth) {
   auto it = std::lower_bound(dhand_depth_seq.begin(), dhand_depth_seq.end(), depth);
   int upper_ind = it - dhand_depth_seq.begin();
 
-  if (*it == depth) { // depth is exactly the dhand depth at upper_ind
+  if (it != dhand_depth_seq.end() && *it == depth) { // depth is exactly the dhand depth at upper_ind
     return {upper_ind, upper_ind};
   }
 
@@ -2319,7 +3583,7 @@ std::pair<int, int> CModel::dhand_bounding_depths(double depth) {
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Generates the interpolated depths of each spp for the "flow_ind"-th flow
+/// \brief Generates the interpolated depths of each spp for the "flow_ind"-th flow, appended to spp_depths
 /// \param flow_ind [in] index of the flow currently being considered
 //
 void CModel::generate_spp_depths(int flow_ind) {
@@ -2349,6 +3613,8 @@ void CModel::generate_spp_depths(int flow_ind) {
   double L1 = PLACEHOLDER; // length for junction nodes
   double L2 = PLACEHOLDER; // length for junction nodes
   double L3 = PLACEHOLDER; // length for junction nodes
+  spp_depths.emplace_back();
+  std::vector<double> &depths = spp_depths.back(); // depths of each spp for this flow profile
 
   // throw error if there are any catchments without snapped pourpoints associated with them
   std::vector<bool> catch_has_spp(bbsn->size());
@@ -2493,7 +3759,7 @@ void CModel::generate_spp_depths(int flow_ind) {
       double ct = CalcCt(max_change, bbopt->postproc_elev_corr_threshold);
 
       // append interpolated depth to spp_depths
-      spp_depths.push_back(ho_depth + (seqelev_j - temp_elev) * ct);
+      depths.push_back(ho_depth + (seqelev_j - temp_elev) * ct);
 
     } else if (pSN->upnodeID2 != -1) { // junction node
       // junction catchment with multiple sets of reaches in it
@@ -2509,14 +3775,14 @@ void CModel::generate_spp_depths(int flow_ind) {
 
       // append interpolated depth to spp_depths
       if (depth_junction != PLACEHOLDER) {
-        spp_depths.push_back(depth_junction); // for now. rob to look at R logic
+        depths.push_back(depth_junction); // for now. rob to look at R logic
         //if (feat->GetFieldAsInteger(spp.get_index_by_fieldname("reachID")) != pSN->reachID) {
         //  spp_depths.push_back(depth_junction);
         //} else {
         //  spp_depths.push_back(PLACEHOLDER);
         //}
       } else {
-        spp_depths.push_back(PLACEHOLDER);
+        depths.push_back(PLACEHOLDER);
       }
 
     } else { // neither headwater nor junction node
@@ -2548,277 +3814,568 @@ void CModel::generate_spp_depths(int flow_ind) {
       double ct = CalcCt(max_change, bbopt->postproc_elev_corr_threshold);
 
       // append interpolated depth to spp_depths
-      spp_depths.push_back(temp_depth + (seqelev_j - temp_elev) * ct);
+      depths.push_back(temp_depth + (seqelev_j - temp_elev) * ct);
     }
   }
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Generates the hand values of each raster cell interpolated from the dhand rasters for the "flow_ind"-th flow
-/// \param flow_ind [in] index of the flow currently being considered
-/// \param is_interp [in] boolean indicating whether or not the post processing method is an interp method
+/// \brief Generates the depth of each catchment for the "num_fp" flows from the "flow_first"-th flow, looked up by
+/// catchment id in the pixel loops
+/// \note catch_depths is indexed directly by streamnode id when the ids span no more than 16 times the number of
+/// streamnodes (or 2^20), otherwise by the index in bbsn through streamnode_map. The depths of all flows of a
+/// catchment are consecutive, so a cell reads those of all flows at once
+/// \param flow_first [in] index of the first flow currently being considered
+/// \param num_fp [in] number of flows currently being considered
 //
-void CModel::generate_dhand_vals(int flow_ind, bool is_interp) {
-  // loop through each raster cell
-  for (int j = 0; j < dhand[0]->xsize * dhand[0]->ysize; j++) {
-    // grab the depth of the current raster cell and flow profile from the hydraulic output
-    double curr_depth = (*hyd_result)[get_hyd_res_index(flow_ind, c_from_s->data[j])]->depth;
-
-    // initialize variables and grab the corresponding dhand bounding depths
-    double curr_dhand_val = PLACEHOLDER;
-    int curr_dhandid_val = PLACEHOLDER;
-    std::pair<int, int> bounds = dhand_bounding_depths(curr_depth);
-
-    // assigns the dhand value of the current raster cell (and dhandid value if interp method)
-    if (bounds.first == bounds.second) { // "depth" is equal to some dhand depth
-      if (std::isnan(dhand[bounds.first]->data[j]) || dhand[bounds.first]->data[j] == dhand[bounds.first]->na_val) {
-        curr_dhand_val = PLACEHOLDER;
-      } else {
-        curr_dhand_val = dhand[bounds.first]->data[j];
-      }
-      if (is_interp) {
-        if (std::isnan(dhandid[bounds.first]->data[j]) || dhandid[bounds.first]->data[j] == dhandid[bounds.first]->na_val) {
-          curr_dhandid_val = PLACEHOLDER;
-        } else {
-          curr_dhandid_val = dhandid[bounds.first]->data[j];
-        }
-      }
-    } else {
-      if (bbopt->dhand_method == enum_dh_method::INTERPOLATE) {
-        if (bounds.first == PLACEHOLDER) { // "depth" is lower than all dhand depths
-          WriteWarning(
-              "Depth of " + std::to_string(curr_depth) +
-                  " is lower than all provided dhand depths. Using "
-                  "closest available dhand, though results should be "
-                  "re-run with more dhand rasters to cover this depth",
-              bbopt->noisy_run);
-          if (std::isnan(dhand[bounds.second]->data[j]) || dhand[bounds.second]->data[j] == dhand[bounds.second]->na_val) {
-            curr_dhand_val = PLACEHOLDER;
-          } else {
-            curr_dhand_val = dhand[bounds.second]->data[j];
-          }
-          if (is_interp) {
-            if (std::isnan(dhandid[bounds.second]->data[j]) || dhandid[bounds.second]->data[j] == dhandid[bounds.second]->na_val) {
-              curr_dhandid_val = PLACEHOLDER;
-            } else {
-              curr_dhandid_val = dhandid[bounds.second]->data[j];
-            }
-          }
-        } else if (bounds.second == PLACEHOLDER) { // "depth" is higher than all dhand depths
-          WriteWarning(
-              "Depth of " + std::to_string(curr_depth) +
-                  " is higher than all provided dhand depths. Using "
-                  "closest available dhand, though results should be "
-                  "re-run with more dhand rasters to cover this depth",
-              bbopt->noisy_run);
-          if (std::isnan(dhand[bounds.first]->data[j]) || dhand[bounds.first]->data[j] == dhand[bounds.first]->na_val) {
-            curr_dhand_val = PLACEHOLDER;
-          } else {
-            curr_dhand_val = dhand[bounds.first]->data[j];
-          }
-          if (is_interp) {
-            if (std::isnan(dhandid[bounds.first]->data[j]) || dhandid[bounds.first]->data[j] == dhandid[bounds.first]->na_val) {
-              curr_dhandid_val = PLACEHOLDER;
-            } else {
-              curr_dhandid_val = dhandid[bounds.first]->data[j];
-            }
+void CModel::generate_catchment_depths(int flow_first, int num_fp) {
+  int n = bbsn->size();
+  catch_depths.clear();
+  catch_num_fp = num_fp;
+  catch_num_slots = 0;
+  if (n == 0) {
+    catch_dense = false;
+    return;
+  }
+  long id_min = (*bbsn)[0]->nodeID, id_max = (*bbsn)[0]->nodeID;
+  for (int i = 1; i < n; i++) {
+    id_min = std::min(id_min, (long)(*bbsn)[i]->nodeID);
+    id_max = std::max(id_max, (long)(*bbsn)[i]->nodeID);
+  }
+  catch_dense = id_max - id_min + 1 <= std::max(16L * n, 1L << 20);
+  catch_id_min = id_min;
+  catch_num_slots = catch_dense ? id_max - id_min + 1 : n;
+  catch_depths.assign(catch_num_slots * num_fp, PLACEHOLDER);
+  for (int i = 0; i < n; i++) {
+    long k = catch_dense ? (*bbsn)[i]->nodeID - id_min : i;
+    for (int f = 0; f < num_fp; f++) {
+      hydraulic_output *ho = (*hyd_result)[(long)(flow_first + f) * n + i];
+      catch_depths[k * num_fp + f] = ho != nullptr ? ho->depth : PLACEHOLDER;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Returns the catchment index in catch_depths (and catch_brackets) of the catchment with id "value"
+/// \param value [in] catchment id, as stored in c_from_s
+/// \note "value" is range checked before it is cast, as float ids may hold any value (e.g., an unmatched no data value)
+/// \return index of the catchment, -1 if "value" is NaN, the no data value, not an integer or outside catch_depths
+//
+long CModel::catchment_index(double value) const {
+  if (std::isnan(value) || value == c_from_s->na_val || value != std::floor(value)) {
+    return -1;
+  }
+  if (catch_dense) {
+    if (value < (double)catch_id_min || value >= (double)catch_id_min + catch_num_slots) {
+      return -1;
+    }
+    return (long)value - catch_id_min;
+  }
+  if (value < (double)std::numeric_limits<int>::min() || value > (double)std::numeric_limits<int>::max()) {
+    return -1;
+  }
+  long k = get_index_by_id((int)value);
+  return k >= 0 && k < catch_num_slots ? k : -1;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Generates the dhand layers and interpolation weights of each catchment and flow from its depth in catch_depths
+/// \note the depth is constant within a catchment, so the bracket is found once per catchment rather than per cell,
+/// and a depth outside of the dhand depths is warned about at most once per catchment and flow
+//
+void CModel::generate_catchment_brackets() {
+  catch_brackets.assign((catch_num_slots + 1) * catch_num_fp, dhand_bracket());
+  std::vector<char> is_catchment(catch_num_slots, catch_dense ? 0 : 1);
+  if (catch_dense) {
+    for (int i = 0; i < bbsn->size(); i++) {
+      is_catchment[(*bbsn)[i]->nodeID - catch_id_min] = 1;
+    }
+  }
+
+  // last brackets are those of cells without a catchment, given a PLACEHOLDER depth
+  for (int f = 0; f < catch_num_fp; f++) {
+    for (long k = 0; k <= catch_num_slots; k++) {
+      double depth = k < catch_num_slots ? catch_depths[k * catch_num_fp + f] : PLACEHOLDER;
+      std::pair<int, int> bounds = dhand_bounding_depths(depth);
+      dhand_bracket &b = catch_brackets[k * catch_num_fp + f];
+
+      if (bounds.first == bounds.second) { // "depth" is equal to some dhand depth
+        b.lower = bounds.first;
+      } else if (bbopt->dhand_method == enum_dh_method::INTERPOLATE) {
+        if (bounds.first == PLACEHOLDER || bounds.second == PLACEHOLDER) { // "depth" is outside of the dhand depths
+          b.lower = bounds.first == PLACEHOLDER ? bounds.second : bounds.first;
+          if (k < catch_num_slots && is_catchment[k]) {
+            WriteWarning(
+                "Depth of " + std::to_string(depth) + " in catchment " +
+                    std::to_string(catch_dense ? catch_id_min + k : (*bbsn)[k]->nodeID) + " is " +
+                    (bounds.first == PLACEHOLDER ? "lower" : "higher") +
+                    " than all provided dhand depths. Using "
+                    "closest available dhand, though results should be "
+                    "re-run with more dhand rasters to cover this depth",
+                bbopt->noisy_run);
           }
         } else { // "depth" is between 2 dhand depths
-          if (std::isnan(dhand[bounds.first]->data[j]) || dhand[bounds.first]->data[j] == dhand[bounds.first]->na_val ||
-              std::isnan(dhand[bounds.second]->data[j]) || dhand[bounds.second]->data[j] == dhand[bounds.second]->na_val) {
-            curr_dhand_val = PLACEHOLDER;
-          } else {
-            double r1 = dhand[bounds.first]->data[j];
-            double r2 = dhand[bounds.second]->data[j];
-            double d1 = dhand_depth_seq[bounds.first];
-            double d2 = dhand_depth_seq[bounds.second];
-
-            curr_dhand_val = r1 * ((d1 - curr_depth) / (d1 - d2)) +
-                             r2 * ((curr_depth - d2) / (d1 - d2));
-            if (is_interp) {
-              if (std::isnan(dhandid[bounds.first]->data[j]) || dhandid[bounds.first]->data[j] == dhandid[bounds.first]->na_val ||
-                  std::isnan(dhandid[bounds.second]->data[j]) || dhandid[bounds.second]->data[j] == dhandid[bounds.second]->na_val) {
-                curr_dhandid_val = PLACEHOLDER;
-              } else {
-                curr_dhandid_val = dhandid[bounds.first]->data[j];
-              }
-            }
-          }
+          double d1 = dhand_depth_seq[bounds.first];
+          double d2 = dhand_depth_seq[bounds.second];
+          b.lower = bounds.first;
+          b.upper = bounds.second;
+          b.w_lower = (d1 - depth) / (d1 - d2);
+          b.w_upper = (depth - d2) / (d1 - d2);
         }
       } else { // enum_dh_method::FLOOR
-        if (bounds.first == PLACEHOLDER) {
-          if (std::isnan(dhand[bounds.second]->data[j]) || dhand[bounds.second]->data[j] == dhand[bounds.second]->na_val) {
-            curr_dhand_val = PLACEHOLDER;
-          } else {
-            curr_dhand_val = dhand[bounds.second]->data[j];
-          }
-          if (is_interp) {
-            if (std::isnan(dhandid[bounds.second]->data[j]) || dhandid[bounds.second]->data[j] == dhandid[bounds.second]->na_val) {
-              curr_dhandid_val = PLACEHOLDER;
-            } else {
-              curr_dhandid_val = dhandid[bounds.second]->data[j];
-            }
-          }
-        } else {
-          if (std::isnan(dhand[bounds.first]->data[j]) || dhand[bounds.first]->data[j] == dhand[bounds.first]->na_val) {
-            curr_dhand_val = PLACEHOLDER;
-          } else {
-            curr_dhand_val = dhand[bounds.first]->data[j];
-          }
-          if (is_interp) {
-            if (std::isnan(dhandid[bounds.first]->data[j]) || dhandid[bounds.first]->data[j] == dhandid[bounds.first]->na_val) {
-              curr_dhandid_val = PLACEHOLDER;
-            } else {
-              curr_dhandid_val = dhandid[bounds.first]->data[j];
-            }
-          }
-        }
+        b.lower = bounds.first == PLACEHOLDER ? bounds.second : bounds.first;
       }
     }
-    // adds dhand value of current raster cell to dhand_vals (and current dhandid to dhandid_vals if interp method)
-    dhand_vals.push_back(curr_dhand_val);
-    if (is_interp) {
-      dhandid_vals.push_back(curr_dhandid_val);
-    }
   }
 }
 
 //////////////////////////////////////////////////////////////////
-/// \brief Generates and saves a gridded data based on the post processing method for the "flow_ind"-th flow
-/// \param flow_ind [in] index of the flow currently being considered
-/// \param is_interp [in] boolean indicated whether post processing method is interp method
-/// \param is_dhand [in] boolean indicated whether post processing method is dhand method
+/// \brief Generates and saves a gridded data of the number of ensemble members whose depth exceeds
+/// bbopt->ensemble_exceedance_depth in each cell
+/// \note the depth of a cell is the depth of its catchment less its hand, so a member exceeds the
+/// exceedance depth where its catchment depth exceeds the hand plus the exceedance depth. This is counted
+/// from the sorted member depths of each catchment, so is only available for the CATCHMENT_HAND method.
+/// Catchments are looked up with catchment_index, so generate_catchment_depths must have been called, and
+/// the raster is computed in tiles of whole rows across worker threads as in compute_out_gridded
 //
-void CModel::generate_out_gridded(int flow_ind, bool is_interp, bool is_dhand) {
-  initialize_out_gridded(is_dhand);
+void CModel::generate_ensemble_exceedance() {
+  static constexpr long TILE_CELLS = 1 << 16; // minimum raster cells handed out to a worker at a time
+
+  if (bbopt->interpolation_postproc_method != enum_ppi_method::CATCHMENT_HAND) {
+    WriteWarning("Model.cpp: generate_ensemble_exceedance: ensemble exceedance counts are only available with the "
+                 "CATCHMENT_HAND post processing method, and are not written",
+                 bbopt->noisy_run);
+    return;
+  }
+  int num_members = ens_member_names.size();
+  initialize_out_gridded(false);
   CGriddedData *result = out_gridded.back().get();
-  result->name = "result_depths_" + fp_names[flow_ind];
-  result->fp_name = fp_names[flow_ind];
-  std::fill(result->data, result->data + (result->xsize * result->ysize), 0.0);
+  result->name = "result_exceedance_count";
+  result->fp_name = "exceedance_count";
 
-  for (int j = 0; j < result->xsize * result->ysize; j++) {
-    double curr_depth, curr_hand;
-    // assign curr_depth based on whether post processing method is interp and/or dhand method
-    if (!is_interp) {
-        double value = c_from_s->data[j];
+  // index in bbsn of each catchment index of catchment_index, -1 for ids without a streamnode
+  std::vector<int> slot_ind(catch_num_slots, -1);
+  for (int i = 0; i < bbsn->size() && catch_num_slots > 0; i++) {
+    slot_ind[catch_dense ? (*bbsn)[i]->nodeID - catch_id_min : i] = i;
+  }
 
-    if (!std::isnan(value) && value != c_from_s->na_val) {
+  long num_cells = (long)result->xsize * result->ysize;
+  long tile_cells = std::max(TILE_CELLS / std::max(result->xsize, 1), 1L) * result->xsize;
+  int num_tiles = tile_cells > 0 ? (int)((num_cells + tile_cells - 1) / tile_cells) : 0;
+  double exceedance_depth = std::max(bbopt->ensemble_exceedance_depth, 1e-9);
+  parallel_for(num_tiles, bbopt->num_threads, [&](int t) {
+    long last = std::min((t + 1) * tile_cells, num_cells);
+    for (long j = t * tile_cells; j < last; j++) {
+      long k = catchment_index(c_from_s->get_value(j));
+      int ind = k >= 0 ? slot_ind[k] : -1;
+      if (ind < 0) {
+        result->set_value(j, result->na_val);
+        continue;
+      }
+      double cell_hand = hand->get_value(j);
+      double curr_hand = !std::isnan(cell_hand) && cell_hand != hand->na_val ? cell_hand : 0.0;
+      if (curr_hand < 0) {
+        curr_hand = 0.0;
+      }
+      const float *depths = &ens_depths[(long)ind * num_members];
+      double threshold = curr_hand + exceedance_depth;
+      result->set_value(j, num_members - (std::upper_bound(depths, depths + num_members, threshold) - depths));
+    }
+  });
 
-        int idx = get_hyd_res_index(flow_ind, value);
+  // Transpose data if writing to NetCDF
+  if (bbopt->out_format == enum_gridded_format::NETCDF) {
+    result->transpose_data();
+  }
+}
 
-        if (idx < 0 || hyd_result == nullptr) {
-            curr_depth = 0.0;
-        } else {
+//////////////////////////////////////////////////////////////////
+/// \brief Generates and saves a gridded data based on the post processing method for each of the "num_fp" flows
+/// from the "flow_first"-th flow
+/// \note the input rasters are read once per cell for all flows, which are those of catch_depths, catch_brackets and spp_depths
+/// \param flow_first [in] index of the first flow currently being considered
+/// \param num_fp [in] number of flows currently being considered
+/// \param is_interp [in] boolean indicated whether post processing method is interp method
+/// \param is_dhand [in] boolean indicated whether post processing method is dhand method
+//
+void CModel::generate_out_gridded(int flow_first, int num_fp, bool is_interp, bool is_dhand) {
+  if (bbopt->postproc_tile_memory > 0) {
+    stream_out_gridded(flow_first, num_fp, is_interp, is_dhand);
+    return;
+  }
+
+  std::vector<CGriddedData *> results(num_fp);
+  for (int f = 0; f < num_fp; f++) {
+    initialize_out_gridded(is_dhand);
+    results[f] = out_gridded.back().get();
+    results[f]->name = "result_depths_" + fp_names[flow_first + f];
+    results[f]->fp_name = fp_names[flow_first + f];
+  }
+  compute_out_gridded(results, is_interp, is_dhand);
+
+  // Transpose data if writing to NetCDF
+  if (bbopt->out_format == enum_gridded_format::NETCDF) {
+    for (CGriddedData *result : results) {
+      result->transpose_data();
+    }
+  }
+}
 
-            hydraulic_output* ho = nullptr;
+//////////////////////////////////////////////////////////////////
+/// \brief Computes the cells of gridded data based on the post processing method for each flow of catch_depths,
+/// specialized on the cell types of the input layers
+/// \note the input rasters are read once per cell for all flows, which are those of catch_depths, catch_brackets and spp_depths.
+/// "results" and the input rasters hold the same cells, either the full rasters or the same rows of streamed rasters,
+/// and "results" are held in the cell type of the hand or dhand layers
+/// \tparam TC [in] cell type of the catchments layer
+/// \tparam TH [in] cell type of the hand or dhand layers
+/// \tparam TI [in] cell type of the handid or dhandid layers
+/// \param results [in/out] gridded data of each flow to write the cells of
+/// \param is_interp [in] boolean indicated whether post processing method is interp method
+/// \param is_dhand [in] boolean indicated whether post processing method is dhand method
+//
+template <typename TC, typename TH, typename TI>
+void CModel::compute_out_gridded_cells(const std::vector<CGriddedData *> &results, bool is_interp, bool is_dhand) {
+  static constexpr long TILE_CELLS = 1 << 16; // minimum raster cells handed out to a worker at a time
+  int num_fp = results.size();
+
+  // raster is split into tiles of whole rows computed across worker threads. Each tile only writes its
+  // own cells, warnings and errors, which are reported afterwards in flow then tile order as a serial pass
+  // over each flow would. Warnings are kept as each distinct handid warned about with its number of cells,
+  // in order of first occurrence, so their memory is bounded by the distinct ids rather than the cells
+  long num_cells = (long)results[0]->xsize * results[0]->ysize;
+  long tile_cells = std::max(TILE_CELLS / std::max(results[0]->xsize, 1), 1L) * results[0]->xsize;
+  int num_tiles = tile_cells > 0 ? (int)((num_cells + tile_cells - 1) / tile_cells) : 0;
+  std::vector<std::vector<std::pair<double, long>>> tile_warnings((long)num_fp * num_tiles);
+  std::vector<std::string> tile_errors((long)num_fp * num_tiles);
+  auto is_valid = [](double value, const CGriddedData *g) { return !std::isnan(value) && value != g->na_val; };
+
+  // cells of the layers as their cell types
+  const TC *catch_cells = c_from_s->cells<TC>();
+  const TH *hand_cells = !is_dhand ? hand->cells<TH>() : nullptr;
+  const TI *handid_cells = is_interp && !is_dhand ? handid->cells<TI>() : nullptr;
+  std::vector<const TH *> dhand_cells(dhand.size());
+  std::vector<const TI *> dhandid_cells(dhandid.size());
+  for (int l = 0; l < dhand.size(); l++) {
+    dhand_cells[l] = dhand[l]->cells<TH>();
+  }
+  for (int l = 0; l < dhandid.size(); l++) {
+    dhandid_cells[l] = dhandid[l]->cells<TI>();
+  }
+  std::vector<TH *> result_cells(num_fp);
+  for (int f = 0; f < num_fp; f++) {
+    result_cells[f] = results[f]->cells<TH>();
+  }
 
-            // bounds check
-            if (idx < hyd_result->size()) {
-                ho = (*hyd_result)[idx];
+  auto handid_warning = [](double id) {
+    return "Model.cpp: postprocess_floodresults: handid specifies a "
+           "pourpoint id of " + std::to_string(id) +
+           " which does not exist in snapped pourpoints. Depths will not be computed for this hand node.";
+  };
+
+  parallel_for(num_tiles, bbopt->num_threads, [&](int t) {
+    std::vector<std::unordered_map<double, std::size_t>> warned(is_interp && !is_dhand ? num_fp : 0); // position in tile_warnings of each id warned about
+    long last = std::min((t + 1) * tile_cells, num_cells);
+    for (long j = t * tile_cells; j < last; j++) {
+      // read the inputs of the cell shared by all flows
+      long k = catchment_index(catch_cells[j]);
+      long kf = (k >= 0 ? k : catch_num_slots) * num_fp; // position of the first flow of the catchment
+      double cell_hand = !is_dhand && is_valid(hand_cells[j], hand.get()) ? hand_cells[j] : PLACEHOLDER;
+      bool has_handid = is_interp && !is_dhand && is_valid(handid_cells[j], handid.get());
+
+      for (int f = 0; f < num_fp; f++) {
+        long e = (long)f * num_tiles + t; // position of the warnings and error of this tile and flow
+        if (!tile_errors[e].empty()) {
+          continue;
+        }
+        double curr_depth, curr_hand;
+
+        // if dhand method, gather the dhand value (and dhandid value if interp method) from the dhand bracket of the catchment
+        double curr_dhand_val = PLACEHOLDER;
+        int curr_dhandid_val = PLACEHOLDER;
+        if (is_dhand) {
+          const dhand_bracket &b = catch_brackets[kf + f];
+          if (b.lower >= 0 && b.upper < 0) {
+            curr_dhand_val = is_valid(dhand_cells[b.lower][j], dhand[b.lower].get()) ? dhand_cells[b.lower][j] : PLACEHOLDER;
+            if (is_interp) {
+              curr_dhandid_val = is_valid(dhandid_cells[b.lower][j], dhandid[b.lower].get()) ? dhandid_cells[b.lower][j] : PLACEHOLDER;
+            }
+          } else if (b.lower >= 0 && is_valid(dhand_cells[b.lower][j], dhand[b.lower].get()) &&
+                     is_valid(dhand_cells[b.upper][j], dhand[b.upper].get())) {
+            curr_dhand_val = dhand_cells[b.lower][j] * b.w_lower + dhand_cells[b.upper][j] * b.w_upper;
+            if (is_interp && is_valid(dhandid_cells[b.lower][j], dhandid[b.lower].get()) &&
+                is_valid(dhandid_cells[b.upper][j], dhandid[b.upper].get())) {
+              curr_dhandid_val = dhandid_cells[b.lower][j];
             }
+          }
+        }
 
-            // null pointer or invalid depth → zero
-            if (ho == nullptr ||
-                std::isnan(ho->depth) ||
-                ho->depth == PLACEHOLDER ||
-                ho->depth < 0.0)
-            {
-                curr_depth = 0.0;
+        // assign curr_depth based on whether post processing method is interp and/or dhand method
+        if (!is_interp) {
+          curr_depth = k >= 0 ? catch_depths[kf + f] : PLACEHOLDER;
+        } else {
+          const std::vector<double> &fp_spp_depths = spp_depths[f];
+          if (!is_dhand) { // interp_hand
+
+              // need to update to look for max index of pointid, not use spp_depths.size()
+            /* if (!std::isnan(handid->data[j]) &&
+                       handid->data[j] != handid->na_val &&
+                 (handid->data[j] - 1 >= spp_depths.size() || handid->data[j] - 1 < 0)) {
+                 ExitGracefully(
+                  ("Model.cpp: postprocess_floodresults: handid specifies a "
+                   "pourpoint id of " + std::to_string(handid->data[j]) +
+                   " which does not exist in snapped pourpoints").c_str(),
+                  exitcode::BAD_DATA);
+             */
+
+            // remove check for handid in spp_depths size for now, should replace with a check that it is in the spp IDs though
+              // make this a warning for now
+            if (has_handid) {
+              auto pos = warned[f].emplace((double)handid_cells[j], tile_warnings[e].size());
+              if (pos.second) {
+                tile_warnings[e].emplace_back((double)handid_cells[j], 0);
+              }
+              tile_warnings[e][pos.first->second].second++;
+              curr_depth = PLACEHOLDER;
             } else {
-                curr_depth = ho->depth;
+                curr_depth = has_handid
+                                    ? fp_spp_depths[handid_cells[j] - 1]
+                                    : PLACEHOLDER;
+            }
+          
+          } else { // interp_dhand
+
+              // need to update to look for max index of pointid, not use spp_depths.size()
+              // commenting check out for now
+            if ((curr_dhandid_val != PLACEHOLDER &&
+                 (curr_dhandid_val - 1 >= fp_spp_depths.size() || curr_dhandid_val - 1 < 0))) {
+              tile_errors[e] =
+                  "Model.cpp: postprocess_floodresults: dhandid specifies a "
+                  "pourpoint id of " + std::to_string(curr_dhandid_val) +
+                  " which does not exist in snapped pourpoints";
+              continue;
             }
+            curr_depth = curr_dhandid_val != PLACEHOLDER
+                             ? fp_spp_depths[curr_dhandid_val - 1]
+                             : PLACEHOLDER;
+          }
         }
 
-    } else {
-        curr_depth = 0.0;
-    }
-        // compact expression form
-        /* curr_depth =
-          !std::isnan(c_from_s->data[j]) && c_from_s->data[j] != c_from_s->na_val
-              ? (*hyd_result)[get_hyd_res_index(flow_ind, c_from_s->data[j])]->depth
-              : PLACEHOLDER;
-        */
-    } else {
-      if (!is_dhand) { // interp_hand
-
-          // need to update to look for max index of pointid, not use spp_depths.size()
-        /* if (!std::isnan(handid->data[j]) &&
-                   handid->data[j] != handid->na_val &&
-             (handid->data[j] - 1 >= spp_depths.size() || handid->data[j] - 1 < 0)) {
-             ExitGracefully(
-              ("Model.cpp: postprocess_floodresults: handid specifies a "
-               "pourpoint id of " + std::to_string(handid->data[j]) +
-               " which does not exist in snapped pourpoints").c_str(),
-              exitcode::BAD_DATA);
-         */
-
-        // remove check for handid in spp_depths size for now, should replace with a check that it is in the spp IDs though
-          // make this a warning for now
-        if (!std::isnan(handid->data[j]) &&
-                           handid->data[j] != handid->na_val) {
-          WriteWarning(
-              ("Model.cpp: postprocess_floodresults: handid specifies a "
-               "pourpoint id of " + std::to_string(handid->data[j]) +
-               " which does not exist in snapped pourpoints. Depths will not be computed for this hand node.").c_str(),
-                   bbopt->noisy_run);  
-          curr_depth = PLACEHOLDER;
+        // Normalize invalid depths: replace PLACEHOLDER, NaN, negatives with zero
+        if (std::isnan(curr_depth) || curr_depth == PLACEHOLDER || curr_depth < 0) {
+            curr_depth = 0.0;
+        }
+
+        // assign curr_hand based on whether post processing method is dhand method
+        if (!is_dhand) {
+          curr_hand = cell_hand;
+        } else {
+          curr_hand = curr_dhand_val;
+        }
+
+        if (std::isnan(curr_hand) || curr_hand == PLACEHOLDER || curr_hand < 0) {
+            curr_hand = 0.0;
+        }
+
+        // assigning resulting value based on curr_depth and curr_hand
+        double depth;
+        if (curr_depth != PLACEHOLDER && curr_hand != PLACEHOLDER && curr_depth >= curr_hand) {
+          depth = curr_depth - curr_hand;
         } else {
-            curr_depth = !std::isnan(handid->data[j]) && handid->data[j] != handid->na_val
-                                ? spp_depths[handid->data[j] - 1]
-                                : PLACEHOLDER;
+          depth = results[f]->na_val;
         }
-        
-      } else { // interp_dhand
-
-          // need to update to look for max index of pointid, not use spp_depths.size()
-          // commenting check out for now
-        if ((dhandid_vals[j] != PLACEHOLDER &&
-             (dhandid_vals[j] - 1 >= spp_depths.size() || dhandid_vals[j] - 1 < 0))) {
-          ExitGracefully(
-              ("Model.cpp: postprocess_floodresults: dhandid specifies a "
-               "pourpoint id of " + std::to_string(dhandid_vals[j]) +
-               " which does not exist in snapped pourpoints").c_str(),
-              exitcode::BAD_DATA);
+
+        // convert all zero depths to NaN
+        if (std::abs(depth) < 1e-9) {
+            depth = std::numeric_limits<double>::quiet_NaN();
         }
-        curr_depth = dhandid_vals[j] != PLACEHOLDER
-                         ? spp_depths[dhandid_vals[j] - 1]
-                         : PLACEHOLDER;
+        result_cells[f][j] = static_cast<TH>(depth);
       }
     }
-
-    // Normalize invalid depths: replace PLACEHOLDER, NaN, negatives with zero
-    if (std::isnan(curr_depth) || curr_depth == PLACEHOLDER || curr_depth < 0) {
-        curr_depth = 0.0;
+  });
+
+  for (int f = 0; f < num_fp; f++) {
+    // merge the warnings of the tiles in tile order, each distinct handid warned once with its number of cells
+    std::vector<std::pair<double, long>> merged;
+    std::unordered_map<double, std::size_t> merged_pos;
+    for (int t = 0; t < num_tiles; t++) {
+      for (const std::pair<double, long> &warn : tile_warnings[(long)f * num_tiles + t]) {
+        auto pos = merged_pos.emplace(warn.first, merged.size());
+        if (pos.second) {
+          merged.emplace_back(warn.first, 0);
+        }
+        merged[pos.first->second].second += warn.second;
+      }
     }
-
-    // assign curr_hand based on whether post processing method is dhand method
-    if (!is_dhand) {
-      curr_hand = !std::isnan(hand->data[j]) && hand->data[j] != hand->na_val ? hand->data[j] : PLACEHOLDER;
-    } else {
-      curr_hand = dhand_vals[j];
+    for (const std::pair<double, long> &warn : merged) {
+      WriteWarning(handid_warning(warn.first) +
+                       (warn.second > 1 ? " (" + std::to_string(warn.second) + " hand nodes)" : ""),
+                   bbopt->noisy_run);
     }
-
-    if (std::isnan(curr_hand) || curr_hand == PLACEHOLDER || curr_hand < 0) {
-        curr_hand = 0.0;
+    for (int t = 0; t < num_tiles; t++) {
+      long e = (long)f * num_tiles + t;
+      if (!tile_errors[e].empty()) {
+        ExitGracefully(tile_errors[e].c_str(), exitcode::BAD_DATA);
+      }
     }
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Computes the cells of gridded data based on the post processing method for each flow of catch_depths
+/// \note dispatches to compute_out_gridded_cells specialized on the cell types of the input layers. Ids are held as
+/// int32 or double and hand values as float or double, see ReadRasterFile and ReadNetCDFLayer
+/// \param results [in/out] gridded data of each flow to write the cells of, held in the cell type of the hand or dhand layers
+/// \param is_interp [in] boolean indicated whether post processing method is interp method
+/// \param is_dhand [in] boolean indicated whether post processing method is dhand method
+//
+void CModel::compute_out_gridded(const std::vector<CGriddedData *> &results, bool is_interp, bool is_dhand) {
+  const CGriddedData *hand_layer = !is_dhand ? hand.get() : dhand[0].get();
+  const CGriddedData *id_layer = !is_interp ? nullptr : !is_dhand ? handid.get() : dhandid[0].get();
+  ExitGracefullyIf(c_from_s->cell_type == CELL_FLOAT32 || hand_layer->cell_type == CELL_INT32 ||
+                       (id_layer && id_layer->cell_type == CELL_FLOAT32),
+                   "Model.cpp: compute_out_gridded: unsupported cell types of the gridded data",
+                   exitcode::RUNTIME_ERR);
+  for (const CGriddedData *result : results) {
+    ExitGracefullyIf(result->cell_type != hand_layer->cell_type,
+                     "Model.cpp: compute_out_gridded: results must be held in the cell type of the hand layers",
+                     exitcode::RUNTIME_ERR);
+  }
 
-    // assigning resulting value based on curr_depth and curr_hand
-    if (curr_depth != PLACEHOLDER && curr_hand != PLACEHOLDER && curr_depth >= curr_hand) {
-      result->data[j] = curr_depth - curr_hand;
+  bool catch_int = c_from_s->cell_type == CELL_INT32;
+  bool hand_float = hand_layer->cell_type == CELL_FLOAT32;
+  bool id_int = id_layer && id_layer->cell_type == CELL_INT32;
+  auto with_id_type = [&](auto tc, auto th) {
+    using TC = decltype(tc);
+    using TH = decltype(th);
+    if (id_int) {
+      compute_out_gridded_cells<TC, TH, int32_t>(results, is_interp, is_dhand);
+    } else {
+      compute_out_gridded_cells<TC, TH, double>(results, is_interp, is_dhand);
+    }
+  };
+  auto with_hand_type = [&](auto tc) {
+    if (hand_float) {
+      with_id_type(tc, float());
     } else {
-      result->data[j] = result->na_val;
+      with_id_type(tc, double());
     }
+  };
+  if (catch_int) {
+    with_hand_type(int32_t());
+  } else {
+    with_hand_type(double());
+  }
+}
 
-    // convert all zero depths to NaN
-    if (std::abs(result->data[j]) < 1e-9) {
-        result->data[j] = std::numeric_limits<double>::quiet_NaN();
+//////////////////////////////////////////////////////////////////
+/// \brief Generates and writes a raster file based on the post processing method for each of the "num_fp" flows
+/// from the "flow_first"-th flow, streaming the input and output rasters in rows
+/// \note rows are processed in strips aligned to the blocks of the catchments raster, holding as many rows of the
+/// needed input rasters and of the outputs as fit in bbopt->postproc_tile_memory. Only the dhand layers used by the
+/// catchments of these flows are read. The output rasters are written directly rather than kept in out_gridded
+/// \param flow_first [in] index of the first flow currently being considered
+/// \param num_fp [in] number of flows currently being considered
+/// \param is_interp [in] boolean indicated whether post processing method is interp method
+/// \param is_dhand [in] boolean indicated whether post processing method is dhand method
+//
+void CModel::stream_out_gridded(int flow_first, int num_fp, bool is_interp, bool is_dhand) {
+  // input rasters read in each strip
+  std::vector<CRaster *> inputs;
+  inputs.push_back(dynamic_cast<CRaster *>(c_from_s.get()));
+  if (!is_dhand) {
+    inputs.push_back(dynamic_cast<CRaster *>(hand.get()));
+    if (is_interp) {
+      inputs.push_back(dynamic_cast<CRaster *>(handid.get()));
+    }
+  } else {
+    std::vector<char> needed(dhand.size(), 0);
+    for (const dhand_bracket &b : catch_brackets) {
+      if (b.lower >= 0) {
+        needed[b.lower] = 1;
+      }
+      if (b.upper >= 0) {
+        needed[b.upper] = 1;
+      }
+    }
+    for (int l = 0; l < dhand.size(); l++) {
+      if (needed[l]) {
+        inputs.push_back(dynamic_cast<CRaster *>(dhand[l].get()));
+        if (is_interp) {
+          inputs.push_back(dynamic_cast<CRaster *>(dhandid[l].get()));
+        }
+      }
     }
+  }
+  int xsize = inputs[0]->xsize;
+  int ysize = inputs[0]->ysize;
+  for (CRaster *input : inputs) {
+    ExitGracefullyIf(input == nullptr || input->dataset == nullptr,
+                     "Model.cpp: stream_out_gridded: input rasters must be opened to be streamed",
+                     exitcode::RUNTIME_ERR);
+    ExitGracefullyIf(input->xsize != xsize || input->ysize != ysize,
+                     ("Model.cpp: stream_out_gridded: raster " + input->name +
+                      " does not have the same dimensions as the catchments raster").c_str(),
+                     exitcode::BAD_DATA);
+  }
 
+  // output rasters, created from the hand raster as in initialize_out_gridded
+  const CRaster *layout = dynamic_cast<const CRaster *>(!is_dhand ? hand.get() : dhand[0].get());
+  std::vector<std::unique_ptr<CRaster>> outputs(num_fp);
+  std::vector<CGriddedData *> results(num_fp);
+  std::vector<std::string> filepaths(num_fp);
+  for (int f = 0; f < num_fp; f++) {
+    outputs[f] = std::make_unique<CRaster>(*layout);
+    outputs[f]->name = "result_depths_" + fp_names[flow_first + f];
+    outputs[f]->fp_name = fp_names[flow_first + f];
+    filepaths[f] = FilenamePrepare("bb_results_depth_" + outputs[f]->fp_name + ".tif");
+    outputs[f]->CreateFile(filepaths[f]);
+    results[f] = outputs[f].get();
   }
 
-  // Transpose data if writing to NetCDF
-  if (bbopt->out_format == enum_gridded_format::NETCDF) {
-    result->transpose_data();
+  // rows per strip within the memory budget, a multiple of the block height of the catchments raster if possible
+  double row_bytes = 0.0;
+  for (CRaster *input : inputs) {
+    row_bytes += (double)input->cell_bytes() * xsize;
+  }
+  for (auto &output : outputs) {
+    row_bytes += (double)output->cell_bytes() * xsize;
+  }
+  int strip_rows = (int)std::min<double>(std::floor(bbopt->postproc_tile_memory * 1024 * 1024 / row_bytes), ysize);
+  int block_xsize = 0, block_ysize = 0;
+  inputs[0]->dataset->GetRasterBand(1)->GetBlockSize(&block_xsize, &block_ysize);
+  if (block_ysize > 0 && strip_rows >= block_ysize) {
+    strip_rows -= strip_rows % block_ysize;
+  }
+  if (strip_rows < 1) {
+    WriteWarning("Model.cpp: stream_out_gridded: :PostprocessingTileMemory is smaller than a single row of the "
+                 "rasters, streaming a row at a time",
+                 bbopt->noisy_run);
+    strip_rows = 1;
+  }
+
+  for (int row_first = 0; row_first < ysize; row_first += strip_rows) {
+    int num_rows = std::min(strip_rows, ysize - row_first);
+    for (CRaster *input : inputs) {
+      input->ReadRows(row_first, num_rows);
+    }
+    for (auto &output : outputs) {
+      output->ResizeRows(num_rows);
+    }
+    compute_out_gridded(results, is_interp, is_dhand);
+    for (auto &output : outputs) {
+      output->WriteRows(row_first);
+    }
+  }
+
+  for (CRaster *input : inputs) {
+    input->ReleaseRows();
+  }
+  for (int f = 0; f < num_fp; f++) {
+    outputs[f]->CloseFile();
+    if (!bbopt->silent_run) {
+      std::cout << filepaths[f] << " successfully written" << std::endl;
+    }
   }
 }
 
@@ -2850,14 +4407,12 @@ void CModel::initialize_out_gridded(bool is_dhand) {
     }
 
     // Assign common variables
-    res_netcdf->data = static_cast<double *>(
-        CPLMalloc(sizeof(double) * hand_raster->xsize * hand_raster->ysize));
-    std::copy(hand_raster->data,
-              hand_raster->data + hand_raster->xsize * hand_raster->ysize,
-              res_netcdf->data);
+    res_netcdf->cell_type = hand_raster->cell_type;
     res_netcdf->xsize = hand_raster->xsize;
     res_netcdf->ysize = hand_raster->ysize;
     res_netcdf->na_val = hand_raster->na_val;
+    res_netcdf->allocate_data();
+    memcpy(res_netcdf->data, hand_raster->data, hand_raster->cell_bytes() * hand_raster->xsize * hand_raster->ysize);
 
     // Convert unique variables
     res_netcdf->x_coords.resize(hand_raster->xsize);
@@ -2896,14 +4451,12 @@ void CModel::initialize_out_gridded(bool is_dhand) {
     }
 
     // Assign common variables
-    res_raster->data = static_cast<double *>(
-        CPLMalloc(sizeof(double) * hand_netcdf->xsize * hand_netcdf->ysize));
-    std::copy(hand_netcdf->data,
-              hand_netcdf->data + hand_netcdf->xsize * hand_netcdf->ysize,
-              res_raster->data);
+    res_raster->cell_type = hand_netcdf->cell_type;
     res_raster->xsize = hand_netcdf->xsize;
     res_raster->ysize = hand_netcdf->ysize;
     res_raster->na_val = hand_netcdf->na_val;
+    res_raster->allocate_data();
+    memcpy(res_raster->data, hand_netcdf->data, hand_netcdf->cell_bytes() * hand_netcdf->xsize * hand_netcdf->ysize);
 
     // Convert unique variables
     res_raster->geotrans[0] = hand_netcdf->x_coords[0];                                                              // Origin X
@@ -28,6 +28,9 @@ public:
   std::vector<std::string> fp_names;                    // names of flowprofiles read in from .bbb
   double flow_mult;                                     // global flow multiplier read in from .bbb
   std::vector<streamnodeconn*> *snconntbl;                // contains data from the snconntbl extracted from bbg files
+  std::vector<std::string> ens_member_names;            // names of ensemble members read in from .bbb in ensemble mode
+  std::vector<int> ens_nodes;                           // index in bbsn of each streamnode with steady flows in ensemble mode
+  std::vector<double> ens_flows;                        // steady flows of each ensemble member, a row of members per entry of ens_nodes
   
 
   // Outputs
@@ -44,16 +47,24 @@ public:
 
   // Functions
   void create_raven_profiles();                                   // creates raven profiles for all streamnodes based on normal depth and preprocessed tables
-  void hyd_compute_profile();                                     // computes hydraulic profile for all streamnodes
+  void hyd_compute_profile(bool incremental = false, const std::vector<char> *fp_active = nullptr); // computes hydraulic profile for all streamnodes of the active flow profiles, or only those affected since the last call if incremental
   void calc_output_flows();                                       // calculates flows of all streamnodes based on headwater nodes steady flows and source sinks
-  double update_spill_flows();                                    // updates spill flows via sources and sinks, and returns the max change in flow
-  void zero_flow_sources();									      // sets flow of all source streamnodes to zero. used in iterative process of updating spill flows via sources and sinks
+  void calc_output_flows_incremental();                           // recalculates flows of streamnodes whose sources or sinks changed since the last flow calculation, and those downstream
+  double update_spill_flows(int f, int num_threads);              // updates spill flows of a flow profile via sources and sinks, and returns the max change in flow
+  void zero_flow_sources(int f);								  // sets flow of all source streamnodes of a flow profile to zero. used in iterative process of updating spill flows via sources and sinks
+  void compute_spill_flows();                                     // iterates on spill flows and hydraulic profiles until the spill flows of all flow profiles converge
+  void compute_ensemble();                                        // solves all ensemble members in batches and keeps their depth quantiles as the flow profiles
+  void add_ensemble_flows(int sid, const std::vector<double> &flows); // adds steady flows of all ensemble members at streamnode with id sid
 
   void add_streamnode(CStreamnode*& pSN);                         // adds streamnode to bbsn and maps
   CStreamnode* get_streamnode_by_id(int sid) const;                     // returns streamnode using id map
-  int get_index_by_id(int id);                                    // returns streamnode index usind id map
-  int get_hyd_res_index(int flow_ind, int sid);                   // returns hyd_result index
+  int get_index_by_id(int id) const;                              // returns streamnode index usind id map
+  int get_hyd_res_index(int flow_ind, int sid) const;             // returns hyd_result index
   void add_snconntbl_row(streamnodeconn*& row);                   // add streamnodeconn row to snconntbl
+  void build_hydtables();                                         // builds hydtable of all streamnodes from their depthdf, resampling if requested
+  void build_normal_depth_ratings();                              // builds normal depth rating of all streamnodes from their hydtable, if requested
+  void compile_topology();                                        // builds index-based stream network links and traversal order of each boundary condition tree
+  void compile_spill_connections();                               // builds the index-based segments of connected streamnode pairs from snconntbl
   
 
   // I/O Functions defined in StandardOutput.cpp
@@ -63,40 +74,74 @@ public:
   void hyd_result_pretty_print() const;                           // writes hyd_result to testoutput
   void hyd_result_pretty_print_csv() const;                       // writes hyd_result to csv file
   void write_catchments_from_streamnodes_json() const;            // writes data for flows, depths, and wsls for each flow profile to an existing json
+  void write_solver_telemetry() const;                            // writes sn_telemetry to csv and summarizes the most expensive streamnodes
+  void write_ensemble_statistics() const;                         // writes depth statistics of the ensemble members of each streamnode to csv
 
   // GIS Functions
   void ReadGISFiles();                                                                                      // reads necessary gis files
   void ReadNetCDFFile(std::string filename);                                                                // reads specified netcdf file
   void ReadNetCDFLayer(CNetCDFLayer *netcdf_obj, int ncid, const std::string &var_name,                          // reads specified netcdf layer
                        int xsize, int ysize, std::vector<double> x_coords,
-                       std::vector<double> y_coords, std::string epsg, int depth_index = -1);
-  void ReadRasterFile(std::string filename, CRaster *raster_obj);                                           // reads specified raster file
+                       std::vector<double> y_coords, std::string epsg, int depth_index = -1, bool is_id = false);
+  void ReadRasterFile(std::string filename, CRaster *raster_obj, bool read_data = true, bool is_id = false); // reads specified raster file, or only opens it to be streamed in rows if read_data is false
   void ReadVectorFile(std::string filename, CVector &vector_obj);                                           // reads specified vector file
   void postprocess_floodresults();                                                                          // postprocesses flood results based on bbopt method
 
 protected:
   // Private variables
   std::unordered_map<int, int> streamnode_map;            // maps streamnode id to index
-  int flow;                                               // index for flow being used in hyd_compute_profile
-  double peak_hrs_min;                                    // minimum hydraulic output peak hours required for all streamnodes in hyd_compute_profile
-  double peak_hrs_max;                                    // maximum hydraulic output peak hours required for all streamnodes in hyd_compute_profile
-  std::vector<double> spp_depths;                         // depths of each spp for a specific flow profile. used in postprocess_floodresults if bbopt->interpolation_postproc_method is an interp method
-  std::vector<double> dhand_vals;                         // hand values interpolated from dhand rasters for specific flow profile. used in postprocess_floodresults if bbopt->interpolation_postproc_method is a dhand method
-  std::vector<int> dhandid_vals;                          // handids corresponding to dhand_vals for specific flow profile. used in postprocess_floodresults if bbopt->interpolation_postproc_method is a dhand method and interp method
+  std::vector<int> sn_downind;                            // index in bbsn of downstream streamnode of each streamnode, -1 if none. built by compile_topology
+  std::vector<int> sn_upind1;                             // index in bbsn of first upstream streamnode of each streamnode, -1 if none. built by compile_topology
+  std::vector<int> sn_upind2;                             // index in bbsn of second upstream streamnode of each streamnode, -1 if none. built by compile_topology
+  std::vector<int> sn_level;                              // number of streamnodes downstream of each streamnode along sn_downind. built by compile_topology
+  std::vector<int> sn_flow_order;                         // index in bbsn of each streamnode in flow accumulation order, each after its upstream streamnodes. built by compile_topology
+  std::vector<compiled_tree> bc_trees;                    // traversal order of the tree of each boundary condition. built by compile_topology
+  spill_connection_graph spill_conn;                      // snconntbl compiled into segments of connected streamnode pairs. built by compile_spill_connections
+  std::vector<critical_depth_curve> crit_curves;          // curve of critical depth versus flow of each streamnode, indexed as in bbsn. reset by build_hydtables
+  std::vector<solver_telemetry> sn_telemetry;             // solver telemetry of each streamnode and flow profile, indexed as in hyd_result. empty if telemetry is off
+  std::vector<double> prev_net_sources;                   // flow sources less sinks of each streamnode and flow profile at the last flow calculation, indexed as in hyd_result. empty unless incremental spill flows are on
+  std::vector<double> solved_down_wsl;                    // downstream wsl each streamnode and flow profile was last solved against, indexed as in hyd_result. PLACEHOLDER if not solved
+  std::vector<double> solved_down_vhead;                  // downstream velocity head each streamnode and flow profile was last solved against, indexed as in hyd_result. PLACEHOLDER if not solved
+  std::vector<float> ens_depths;                          // depth of each streamnode and ensemble member, a row of members per streamnode sorted by compute_ensemble
+  std::vector<spill_acceleration> spill_accel;            // state of the spill flow iteration of each flow profile. reset by compute_spill_flows, empty unless the iteration is tracked
+  long wsl_cold_solves;                                   // total number of brent or newton wsl solves without a prior wsl over all hyd_compute_profile calls
+  long wsl_cold_evals;                                    // total number of residual evaluations of brent or newton wsl solves without a prior wsl over all hyd_compute_profile calls
+  std::vector<double> catch_depths;                       // depth of each catchment and flow profile of the current block, indexed as catchment index * catch_num_fp + profile. PLACEHOLDER for ids without a streamnode. used in postprocess_floodresults
+  long catch_num_slots;                                   // number of catchment indices of catch_depths, streamnode ids less catch_id_min if catch_dense, otherwise indices in bbsn
+  int catch_num_fp;                                       // number of flow profiles in the current block of catch_depths
+  int catch_id_min;                                       // smallest streamnode id, offset of catch_depths if catch_dense
+  bool catch_dense;                                       // true if catch_depths is indexed directly by streamnode id, false if the streamnode ids are too sparse
+  std::vector<std::vector<double>> spp_depths;            // depths of each spp for each flow profile of the current block. used in postprocess_floodresults if bbopt->interpolation_postproc_method is an interp method
+  std::vector<dhand_bracket> catch_brackets;              // dhand bracket of each catchment and flow profile of the current block, indexed as catch_depths, followed by those of cells without a catchment. used in postprocess_floodresults if bbopt->interpolation_postproc_method is a dhand method
 
   // Private functions
-  void compute_streamnode(CStreamnode *&sn, CStreamnode *&down_sn, std::vector<hydraulic_output *> *&res, CBoundaryCondition *&bc); // helper function used in hyd_compute_profile
-  double solve_critical_wsl_brent(const CStreamnode* sn_up, const CStreamnode* sn_down);                             // solver for critical wsl using brent method. 
-  double solve_critical_wsl_exhaustive(const CStreamnode* sn_up, const CStreamnode* sn_down);                             // solver for critical wsl using refined exhaustive search.
-  double solve_critical_wsl_brent_analytical(const CStreamnode* sn_up, const CStreamnode* sn_down);                  // solver for critical wsl using brent method.          
+  void compute_flow_profile(profile_workspace &ws, int num_threads);                                                                 // computes hydraulic profile of a single flow profile for all boundary conditions. used in hyd_compute_profile
+  long compute_hand_manning_profiles(int num_fp, int num_threads, bool incremental, const std::vector<char> *fp_active, std::vector<double> &fp_peak_hrs_min, std::vector<double> &fp_peak_hrs_max); // computes all streamnode and flow profile pairs independently in HAND_MANNING mode. used in hyd_compute_profile
+  void compute_streamnode(int ind, int down_ind, std::vector<hydraulic_output *> *&res, CBoundaryCondition *&bc, profile_workspace &ws); // helper function used in hyd_compute_profile
+  void compute_streamnode_incremental(int ind, int down_ind, CBoundaryCondition *&bc, profile_workspace &ws);                          // re-solves streamnode only if its flow or downstream state moved beyond tolerance. used in hyd_compute_profile
+  void load_ensemble_batch(int first, int num);                                                                                       // sets the flow profiles of all streamnodes to ensemble members [first, first + num)
+  void clear_hyd_result();                                                                                                            // deletes hyd_result and its hydraulic outputs
+  void record_net_sources();                                                                                                          // stores sources less sinks of all streamnodes in prev_net_sources
+  double solve_critical_wsl_brent(const CStreamnode* sn_up, const CStreamnode* sn_down, const hydraulic_output *mm_up, const hydraulic_output *mm_down);            // solver for critical wsl using brent method. 
+  double solve_critical_wsl_exhaustive(const CStreamnode* sn_up, const CStreamnode* sn_down, const hydraulic_output *mm_up, const hydraulic_output *mm_down, solver_telemetry &tm);       // solver for critical wsl using refined exhaustive search.
+  double solve_critical_wsl_cached(int ind, const CStreamnode* sn_up, const hydraulic_output *mm_up, profile_workspace &ws, solver_telemetry &tm);       // critical wsl interpolated from the critical depth curve of sn_up, recomputed exactly if the cached error bound is exceeded
+  double solve_critical_wsl_brent_analytical(const CStreamnode* sn_up, const CStreamnode* sn_down, const hydraulic_output *mm_up, const hydraulic_output *mm_down); // solver for critical wsl using brent method.          
   
-  double solve_wsl_standard_step_brent(const CStreamnode* sn_up, const CStreamnode* sn_down,  double wsl_critical ); // solver for estimated wsl using brent method. used in hyd_compute_profile
-  ExhaustiveWSLResult solve_wsl_exhaustive(const CStreamnode* sn_up, const CStreamnode* sn_down); // solver for estimated wsl using exhaustive search. used in hyd_compute_profile
+  double solve_wsl_standard_step_brent(const CStreamnode* sn_up, const CStreamnode* sn_down, const hydraulic_output *mm_up, const hydraulic_output *mm_down, double wsl_critical, double wsl_prior, solver_telemetry &tm); // solver for estimated wsl using brent method. used in hyd_compute_profile
+  double solve_wsl_standard_step_newton(const CStreamnode* sn_up, const CStreamnode* sn_down, const hydraulic_output *mm_up, const hydraulic_output *mm_down, double wsl_critical, double wsl_prior, solver_telemetry &tm); // solver for estimated wsl using safeguarded newton method. used in hyd_compute_profile
+  ExhaustiveWSLResult solve_wsl_exhaustive(const CStreamnode* sn_up, const CStreamnode* sn_down, hydraulic_output *mm_up, const hydraulic_output *mm_down, solver_telemetry &tm); // solver for estimated wsl using exhaustive search. used in hyd_compute_profile
 
   std::pair<int, int> dhand_bounding_depths(double depth);                                                                           // finds nearest dhands to use in postprocess_floodresults
-  void generate_spp_depths(int flow_ind);                                                                                            // generates spp_depths for the flow_ind-th profile. used in postprocess_floodresults
-  void generate_dhand_vals(int flow_ind, bool is_interp);                                                                            // generates dhand_vals for the flow_ind-th profile. used in postprocess_floodresults
-  void generate_out_gridded(int flow_ind, bool is_interp, bool is_dhand);                                                            // generates an output gridded for the flow_ind-th profile. used in postprocess_floodresults
+  void generate_catchment_depths(int flow_first, int num_fp);                                                                        // generates catch_depths for num_fp profiles from the flow_first-th profile. used in postprocess_floodresults
+  long catchment_index(double value) const;                                                                                          // returns index in catch_depths of catchment with id "value", -1 if none. used in postprocess_floodresults
+  void generate_catchment_brackets();                                                                                                // generates catch_brackets from catch_depths. used in postprocess_floodresults
+  void generate_spp_depths(int flow_ind);                                                                                            // appends spp_depths of the flow_ind-th profile. used in postprocess_floodresults
+  void generate_ensemble_exceedance();                                                                                               // generates an output gridded of the number of ensemble members exceeding the exceedance depth. used in postprocess_floodresults
+  void generate_out_gridded(int flow_first, int num_fp, bool is_interp, bool is_dhand);                                              // generates output gridded data for num_fp profiles from the flow_first-th profile in a single raster pass. used in postprocess_floodresults
+  void compute_out_gridded(const std::vector<CGriddedData *> &results, bool is_interp, bool is_dhand);                               // computes the cells of the output gridded data of each profile of catch_depths. used in generate_out_gridded
+  template <typename TC, typename TH, typename TI>
+  void compute_out_gridded_cells(const std::vector<CGriddedData *> &results, bool is_interp, bool is_dhand);                         // compute_out_gridded specialized on the cell types of catchments, hand layers and id layers. used in compute_out_gridded
+  void stream_out_gridded(int flow_first, int num_fp, bool is_interp, bool is_dhand);                                                // generates and writes output rasters for num_fp profiles from the flow_first-th profile, streaming rasters in rows. used in generate_out_gridded
   void initialize_out_gridded(bool is_dhand);                                                                                        // initializes an output gridded data instance for the flow ind-th profile. used in generate_out_gridded
 };
 
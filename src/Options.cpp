@@ -15,6 +15,7 @@ COptions::COptions()
   solvermethod(enum_sm_method::BRENT),
   dx(0.1),
   extrapolate_depth_table(true),
+  resample_depth_step(PLACEHOLDER),
   num_extrapolation_points(PLACEHOLDER),
   friction_slope_method(enum_fs_method::AVERAGE_CONVEYANCE),
   xsection_conveyance_method(enum_xsc_method::OVERBANK_CONVEYANCE),
@@ -43,6 +44,8 @@ COptions::COptions()
   interpolation_postproc_method(enum_ppi_method::CATCHMENT_HAND),
   dhand_method(enum_dh_method::INTERPOLATE),
   postproc_elev_corr_threshold(PLACEHOLDER),
+  postproc_block_size(1),
+  postproc_tile_memory(0.0),
   roughness_multiplier(1.),
   blended_conveyance_weights(PLACEHOLDER),
   blended_nc_weights(PLACEHOLDER),
@@ -58,7 +61,25 @@ COptions::COptions()
   write_catchment_json(false),
   enable_exhaustive(false),
   create_raven_profiles(false),
-  skip_headwater(false){
+  skip_headwater(false),
+  num_threads(1),
+  warm_start_wsl(false),
+  warm_start_window(0.25),
+  critical_depth_cache(false),
+  critical_depth_cache_tol(0.01),
+  write_solver_telemetry(false),
+  telemetry_top_n(10),
+  normal_depth_rating(false),
+  incremental_spill_flows(false),
+  spill_resolve_flow_tol(0.001),
+  spill_resolve_level_tol(0.001),
+  spill_acceleration(enum_sa_method::NO_ACCELERATION),
+  spill_anderson_depth(5),
+  write_spill_convergence(false),
+  ensemble_mode(false),
+  ensemble_batch_size(50),
+  ensemble_quantiles({0.1, 0.5, 0.9}),
+  ensemble_exceedance_depth(0.0){
 }
 
 //////////////////////////////////////////////////////////////////
@@ -18,9 +18,10 @@ public:
 
   enum_mt_method modeltype;                         // type of model. options: HAND_MANNING, STEADYFLOW
   enum_rt_method regimetype;                        // type of regime. options: SUBCRITICAL, SUPERCRITICAL, MIXED
-  enum_sm_method solvermethod;                      // method for solving for depth. options: BRENT, SECANT
+  enum_sm_method solvermethod;                      // method for solving for depth. options: BRENT, SECANT, EXHAUSTIVE, NEWTON
   double dx;                                        // dx to use for cross section calculations
   bool extrapolate_depth_table;                     // on extrapolation beyond depth range of the table, true -> throw warning but extrapolate, false -> throw error and stop
+  double resample_depth_step;                       // depth step (m) of uniform grid onto which reach depth tables are resampled at load time. PLACEHOLDER -> no resampling
   double num_extrapolation_points;                  // number of extrapolation points. unused?
   enum_fs_method friction_slope_method;             // friction slope method. options: AVERAGE_CONVEYANCE, AVERAGE_FRICTION, GEOMETRIC_FRICTON, HARMONIC_FRICTION, REACH_FRICTION
   enum_xsc_method xsection_conveyance_method;       // xsection conveyance method. options: OVERBANK_CONVEYANCE, DEFAULT_CONVEYANCE, COORDINATE_CONVEYANCE, DISCRETIZED_CONVEYANCE_XS, AREAWEIGHTED_CONVEYANCE_ONECALC_XS, AREAWEIGHTED_CONVEYANCE
@@ -49,6 +50,8 @@ public:
   enum_ppi_method interpolation_postproc_method;    // post-processing interpolation method. options: NONE, CATCHMENT_HAND, CATCHMENT_DHAND, INTERP_HAND, INTERP_DHAND, INTERP_DHAND_WSLCORR
   enum_dh_method dhand_method;                      // post-processing dhand method. options: INTERPOLATE, FLOOR
   double postproc_elev_corr_threshold;              // post-processing elevation correction threshold
+  int postproc_block_size;                          // number of flow profiles post-processed together in a single pass over the rasters. <= 0 -> all flow profiles
+  double postproc_tile_memory;                      // memory budget in MB of the rows of input and output rasters held at once when streaming rasters in post-processing. <= 0 -> rasters are read in full
   double roughness_multiplier;                      // roughness multiplier applied to all manning's n values
   double blended_conveyance_weights;                // unused?
   double blended_nc_weights;                        // unused?
@@ -61,6 +64,24 @@ public:
   bool enable_exhaustive;                           // enables using exhausting solution in compute_streamnode if secant method is producing strange results
   bool create_raven_profiles;						// boolean representing whether or not to create Raven profiles for each streamnode. If True, Raven profiles are created in the output folder
   bool skip_headwater;								// boolean representing whether or not to skip headwater basins in mapping. If true, hwadwater basins receive a flow of zero and are skipped in mapping
+  bool warm_start_wsl;                              // true -> brent wsl solves start from a bracket around, and newton wsl solves from, the prior solution at each streamnode, if available
+  double warm_start_window;                         // half width (m) of the initial warm start bracket around the prior wsl
+  bool critical_depth_cache;                        // true -> critical depths are interpolated from a per-streamnode curve of critical depth versus flow
+  double critical_depth_cache_tol;                  // maximum change (m) in critical depth across a rung of the flow ladder for interpolation, otherwise recomputed exactly
+  bool write_solver_telemetry;                      // true -> per-streamnode solver counters and timings are written to SolverTelemetry.csv, with the most expensive streamnodes summarized
+  int telemetry_top_n;                              // number of most expensive streamnodes reported in the solver telemetry summary
+  bool normal_depth_rating;                         // true -> normal depths are looked up from a per-streamnode rating of wsl versus conveyance built once from the depth table
+  bool incremental_spill_flows;                     // true -> spill flow iterations recalculate flows and re-solve only the streamnodes affected by changed sources
+  double spill_resolve_flow_tol;                    // relative change in flow beyond which a streamnode is re-solved in incremental spill flows
+  double spill_resolve_level_tol;                   // change (m) in wsl or velocity head of the downstream streamnode beyond which a streamnode is re-solved in incremental spill flows
+  enum_sa_method spill_acceleration;                // method used to accelerate the fixed-point iteration of spill flow transfers
+  int spill_anderson_depth;                         // maximum number of previous iterations used by anderson acceleration of spill flows
+  bool write_spill_convergence;                     // true -> residuals of the spill flow iteration of each flow profile are written to SpillFlowConvergence.csv
+  bool ensemble_mode;                               // true -> flow profiles of :SteadyFlows are ensemble members, solved in batches with only aggregate outputs written
+  int ensemble_batch_size;                          // number of ensemble members solved together in a batch
+  std::vector<double> ensemble_quantiles;           // quantiles [0..1] of member depths written per streamnode and used as the output flow profiles in ensemble mode
+  double ensemble_exceedance_depth;                 // depth (m) a member must exceed to be counted in the exceedance counts of ensemble mode
+  int num_threads;                                  // number of worker threads used to compute flow profiles, spread over profiles then over branches within a profile. <= 0 -> all available hardware threads
 
   bool silent_run;                                  // true -> print less logs
   bool noisy_run;                                   // true -> print more logs
@@ -197,6 +197,9 @@ bool ParseBoundaryConditionsFile(CModel*& pModel, COptions*const& pOptions)
       if (pOptions->noisy_run) { std::cout << "Steady flows table..." << std::endl; }
       bool done = false;
       int row = 0;
+      // ensemble members are kept by the model as a dense table rather than as flow profiles of each streamnode
+      std::vector<std::string> &names = pOptions->ensemble_mode ? pModel->ens_member_names : pModel->fp_names;
+      std::vector<double> member_flows;
       if (Len != 1) { pp->ImproperFormat(s); }
       else {
         std::string error;
@@ -208,13 +211,13 @@ bool ParseBoundaryConditionsFile(CModel*& pModel, COptions*const& pOptions)
           {
             if (Len < 3) { pp->ImproperFormat(s); }
             for (int i = 2; i < Len; i++) {
-              pModel->fp_names.push_back(s[i]);
+              names.push_back(s[i]);
             }
           }
           else if (!strcmp(s[0], ":EndSteadyFlows")) { done = true; }
           else
           {
-            if (pModel->fp_names.empty()) {
+            if (names.empty()) {
                 error = "ParseBoundaryConditions File: :Attributes must be specified at the beginning of  :SteadyFlows block";
                 ExitGracefully(error.c_str(), BAD_DATA_WARN);
             }
@@ -232,8 +235,12 @@ bool ParseBoundaryConditionsFile(CModel*& pModel, COptions*const& pOptions)
               error = "ParseBoundaryConditions File: nodeID \"" + std::string(s[0]) + "\" in row " + std::to_string(row) + " of  :SteadyFlows must be unique integer or long integer";
               ExitGracefully(error.c_str(), BAD_DATA_WARN);
             }
-            for (int i = 1; i < pModel->fp_names.size() + 1; i++) {
-              if (StringIsDouble(s[i])) {
+            member_flows.clear();
+            for (int i = 1; i < names.size() + 1; i++) {
+              if (pOptions->ensemble_mode && StringIsDouble(s[i])) {
+                member_flows.push_back(std::stod(s[i]));
+              }
+              else if (StringIsDouble(s[i])) {
                 pSN->add_steadyflow(std::stod(s[i]));
               }
               else {
@@ -241,6 +248,9 @@ bool ParseBoundaryConditionsFile(CModel*& pModel, COptions*const& pOptions)
                 ExitGracefully(error.c_str(), BAD_DATA_WARN);
               }
             }
+            if (pOptions->ensemble_mode) {
+              pModel->add_ensemble_flows(pSN->nodeID, member_flows);
+            }
           }
         }
       }
@@ -253,6 +263,9 @@ bool ParseBoundaryConditionsFile(CModel*& pModel, COptions*const& pOptions)
       ExitGracefullyIf(pOptions->enable_spill_flows == true, 
         "ParseBoundaryConditions File: Explicit flows are provided, these cannot be used with spill flows.", 
         BAD_DATA);
+      ExitGracefullyIf(pOptions->ensemble_mode == true,
+        "ParseBoundaryConditions File: Explicit flows are provided, these cannot be used with :EnsembleMode.",
+        BAD_DATA);
       // rest is the same as SteadyFlows, should replace with a function here or other call
       bool done = false;
       int row = 0;
@@ -311,6 +324,9 @@ bool ParseBoundaryConditionsFile(CModel*& pModel, COptions*const& pOptions)
       ExitGracefullyIf(pOptions->explicit_flows == true, 
           "ParseBoundaryConditions File: Explicit flows are provided, these cannot be used with :StreamnodeSourcesSinks.", 
           BAD_DATA);
+      ExitGracefullyIf(pOptions->ensemble_mode == true,
+          "ParseBoundaryConditions File: :StreamnodeSourcesSinks cannot be used with :EnsembleMode.",
+          BAD_DATA);
       bool done = false;
       int row = 0;
       if (Len != 1) { pp->ImproperFormat(s); }
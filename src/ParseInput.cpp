@@ -39,12 +39,16 @@ bool ParseInputFiles(CModel*& pModel,
   if (!ParseGeometryFile(pModel, pOptions)) {
     ExitGracefully("Cannot find or read .bbg file", BAD_DATA);return false;
   }
+  pModel->build_hydtables();
+  pModel->build_normal_depth_ratings();
 
   // Boundary Conditions file (.bbb)
   //--------------------------------------------------------------------------------
   if (!ParseBoundaryConditionsFile(pModel, pOptions)) {
     ExitGracefully("Cannot find or read .bbb file", BAD_DATA);return false;
   }
+  pModel->compile_topology();
+  pModel->compile_spill_connections();
 
   if (!pOptions->silent_run) {
     std::cout << "...model input successfully parsed" << std::endl;
@@ -160,6 +164,17 @@ bool ParseMainInputFile(CModel*& pModel,
     else if (!strcmp(s[0], ":SpillFlowMinFlowPercent"))     { code = 39; }
     else if (!strcmp(s[0], ":SpillFlowMaxDeltaFlow"))       { code = 40; }
     else if (!strcmp(s[0], ":SpillFlowDeltaThreshold"))     { code = 41; }
+    else if (!strcmp(s[0], ":ResampleDepthTable"))          { code = 42; }
+    else if (!strcmp(s[0], ":NumThreads"))                  { code = 43; }
+    else if (!strcmp(s[0], ":WarmStartWSL"))                { code = 44; }
+    else if (!strcmp(s[0], ":CriticalDepthCache"))          { code = 45; }
+    else if (!strcmp(s[0], ":WriteSolverTelemetry"))        { code = 46; }
+    else if (!strcmp(s[0], ":NormalDepthRating"))           { code = 47; }
+    else if (!strcmp(s[0], ":IncrementalSpillFlows"))       { code = 48; }
+    else if (!strcmp(s[0], ":SpillFlowAcceleration"))       { code = 49; }
+    else if (!strcmp(s[0], ":EnsembleMode"))                { code = 50; }
+    else if (!strcmp(s[0], ":EnsembleQuantiles"))           { code = 51; }
+    else if (!strcmp(s[0], ":EnsembleExceedanceDepth"))     { code = 52; }
 
 
 
@@ -178,6 +193,8 @@ bool ParseMainInputFile(CModel*& pModel,
     else if (!strcmp(s[0], ":PostprocessingInterpolationMethod")) { code = 400; }
     else if (!strcmp(s[0], ":DHandMethod")) { code = 401; }
     else if (!strcmp(s[0], ":GISPath")) { code = 402; }
+    else if (!strcmp(s[0], ":PostprocessingBlockSize")) { code = 403; }
+    else if (!strcmp(s[0], ":PostprocessingTileMemory")) { code = 404; }
 
     //-------------------- OTHER SPECIAL OPTIONS ------------------------
     else if (!strcmp(s[0], ":CreateRavenProfiles")) { code = 500; }
@@ -477,7 +494,8 @@ bool ParseMainInputFile(CModel*& pModel,
       if (!strcmp(s[1], "BRENT")) { pOptions->solvermethod = enum_sm_method::BRENT; }
       else if (!strcmp(s[1], "SECANT")) { pOptions->solvermethod = enum_sm_method::SECANT; }
       else if (!strcmp(s[1], "EXHAUSTIVE")) { pOptions->solvermethod = enum_sm_method::EXHAUSTIVE; }
-      else { ExitGracefully("ParseMainInputFile: unrecognized SolverMethod. options are: BRENT or SECANT", exitcode::BAD_DATA); }
+      else if (!strcmp(s[1], "NEWTON")) { pOptions->solvermethod = enum_sm_method::NEWTON; }
+      else { ExitGracefully("ParseMainInputFile: unrecognized SolverMethod. options are: BRENT, SECANT, EXHAUSTIVE or NEWTON", exitcode::BAD_DATA); }
       break;
     }
     case (34): { /*:DontWriteHydraulicOutput*/
@@ -531,6 +549,115 @@ bool ParseMainInputFile(CModel*& pModel,
       pOptions->spilldepthchangetol = std::atof(s[1]);
       break;
     } 
+    case(42): {/*:ResampleDepthTable [double depth_step]*/
+      if (pOptions->noisy_run) { std::cout << "ResampleDepthTable" << std::endl; }
+      if (Len < 2) { ImproperFormatWarning(":ResampleDepthTable", p, pOptions->noisy_run); break; }
+      pOptions->resample_depth_step = std::atof(s[1]);
+      ExitGracefullyIf(pOptions->resample_depth_step <= 0,
+        "ParseMainInputFile: :ResampleDepthTable depth step must be a positive value", exitcode::BAD_DATA);
+      break;
+    }
+    case(43): {/*:NumThreads [int num_threads]*/
+      if (pOptions->noisy_run) { std::cout << "NumThreads" << std::endl; }
+      if (Len < 2) { ImproperFormatWarning(":NumThreads", p, pOptions->noisy_run); break; }
+      pOptions->num_threads = std::atoi(s[1]); // <= 0 -> all available hardware threads
+      break;
+    }
+    case(44): {/*:WarmStartWSL [double half_width (optional)]*/
+      if (pOptions->noisy_run) { std::cout << "WarmStartWSL" << std::endl; }
+      pOptions->warm_start_wsl = true;
+      if (Len >= 2) {
+        pOptions->warm_start_window = std::atof(s[1]);
+        ExitGracefullyIf(pOptions->warm_start_window <= 0,
+          "ParseMainInputFile: :WarmStartWSL half width must be a positive value", exitcode::BAD_DATA);
+      }
+      break;
+    }
+    case(45): {/*:CriticalDepthCache [double tolerance (optional)]*/
+      if (pOptions->noisy_run) { std::cout << "CriticalDepthCache" << std::endl; }
+      pOptions->critical_depth_cache = true;
+      if (Len >= 2) {
+        pOptions->critical_depth_cache_tol = std::atof(s[1]);
+        ExitGracefullyIf(pOptions->critical_depth_cache_tol <= 0,
+          "ParseMainInputFile: :CriticalDepthCache tolerance must be a positive value", exitcode::BAD_DATA);
+      }
+      break;
+    }
+    case(46): {/*:WriteSolverTelemetry [int top_n (optional)]*/
+      if (pOptions->noisy_run) { std::cout << "WriteSolverTelemetry" << std::endl; }
+      pOptions->write_solver_telemetry = true;
+      if (Len >= 2) {
+        pOptions->telemetry_top_n = std::atoi(s[1]);
+        ExitGracefullyIf(pOptions->telemetry_top_n <= 0,
+          "ParseMainInputFile: :WriteSolverTelemetry number of streamnodes must be a positive value", exitcode::BAD_DATA);
+      }
+      break;
+    }
+    case(47): {/*:NormalDepthRating*/
+      if (pOptions->noisy_run) { std::cout << "NormalDepthRating" << std::endl; }
+      pOptions->normal_depth_rating = true;
+      break;
+    }
+    case(48): {/*:IncrementalSpillFlows [double flow_tolerance (optional)] [double level_tolerance (optional)]*/
+      if (pOptions->noisy_run) { std::cout << "IncrementalSpillFlows" << std::endl; }
+      pOptions->incremental_spill_flows = true;
+      if (Len >= 2) {
+        pOptions->spill_resolve_flow_tol = std::atof(s[1]);
+        ExitGracefullyIf(pOptions->spill_resolve_flow_tol < 0,
+          "ParseMainInputFile: :IncrementalSpillFlows flow tolerance must not be negative", exitcode::BAD_DATA);
+      }
+      if (Len >= 3) {
+        pOptions->spill_resolve_level_tol = std::atof(s[2]);
+        ExitGracefullyIf(pOptions->spill_resolve_level_tol < 0,
+          "ParseMainInputFile: :IncrementalSpillFlows level tolerance must not be negative", exitcode::BAD_DATA);
+      }
+      break;
+    }
+    case(49): {/*:SpillFlowAcceleration [string method] [int depth (optional)]*/
+      if (pOptions->noisy_run) { std::cout << "SpillFlowAcceleration" << std::endl; }
+      if (Len < 2) { ImproperFormatWarning(":SpillFlowAcceleration", p, pOptions->noisy_run); break; }
+      if (!strcmp(s[1], "NONE")) { pOptions->spill_acceleration = enum_sa_method::NO_ACCELERATION; }
+      else if (!strcmp(s[1], "AITKEN")) { pOptions->spill_acceleration = enum_sa_method::AITKEN; }
+      else if (!strcmp(s[1], "ANDERSON")) { pOptions->spill_acceleration = enum_sa_method::ANDERSON; }
+      else { ExitGracefully("ParseMainInputFile: unrecognized SpillFlowAcceleration. options are: NONE, AITKEN, and ANDERSON", exitcode::BAD_DATA); }
+      pOptions->write_spill_convergence = true;
+      if (Len >= 3) {
+        pOptions->spill_anderson_depth = std::atoi(s[2]);
+        ExitGracefullyIf(pOptions->spill_anderson_depth <= 0,
+          "ParseMainInputFile: :SpillFlowAcceleration depth must be a positive value", exitcode::BAD_DATA);
+      }
+      break;
+    }
+    case(50): {/*:EnsembleMode [int batch_size (optional)]*/
+      if (pOptions->noisy_run) { std::cout << "EnsembleMode" << std::endl; }
+      pOptions->ensemble_mode = true;
+      if (Len >= 2) {
+        pOptions->ensemble_batch_size = std::atoi(s[1]);
+        ExitGracefullyIf(pOptions->ensemble_batch_size <= 0,
+          "ParseMainInputFile: :EnsembleMode batch size must be a positive value", exitcode::BAD_DATA);
+      }
+      break;
+    }
+    case(51): {/*:EnsembleQuantiles [double q1] [double q2] ...*/
+      if (pOptions->noisy_run) { std::cout << "EnsembleQuantiles" << std::endl; }
+      if (Len < 2) { ImproperFormatWarning(":EnsembleQuantiles", p, pOptions->noisy_run); break; }
+      pOptions->ensemble_quantiles.clear();
+      for (int i = 1; i < Len; i++) {
+        double q = std::atof(s[i]);
+        ExitGracefullyIf(q < 0 || q > 1,
+          "ParseMainInputFile: :EnsembleQuantiles quantiles must be between 0 and 1", exitcode::BAD_DATA);
+        pOptions->ensemble_quantiles.push_back(q);
+      }
+      break;
+    }
+    case(52): {/*:EnsembleExceedanceDepth [double depth]*/
+      if (pOptions->noisy_run) { std::cout << "EnsembleExceedanceDepth" << std::endl; }
+      if (Len < 2) { ImproperFormatWarning(":EnsembleExceedanceDepth", p, pOptions->noisy_run); break; }
+      pOptions->ensemble_exceedance_depth = std::atof(s[1]);
+      ExitGracefullyIf(pOptions->ensemble_exceedance_depth < 0,
+        "ParseMainInputFile: :EnsembleExceedanceDepth depth must not be negative", exitcode::BAD_DATA);
+      break;
+    }
     case(100):
     {/*:RoughnessMultiplier [double mult]*/
       if (pOptions->noisy_run) { std::cout << "RoughnessMultiplier" << std::endl; }
@@ -606,6 +733,20 @@ bool ParseMainInputFile(CModel*& pModel,
       pOptions->gis_path = s[1];
       break;
     }
+    case(403):
+    {/*:PostprocessingBlockSize [int num_profiles]*/
+      if (pOptions->noisy_run) { std::cout << "PostprocessingBlockSize" << std::endl; }
+      if (Len < 2) { ImproperFormatWarning(":PostprocessingBlockSize", p, pOptions->noisy_run); break; }
+      pOptions->postproc_block_size = std::atoi(s[1]); // <= 0 -> all flow profiles
+      break;
+    }
+    case(404):
+    {/*:PostprocessingTileMemory [double megabytes]*/
+      if (pOptions->noisy_run) { std::cout << "PostprocessingTileMemory" << std::endl; }
+      if (Len < 2) { ImproperFormatWarning(":PostprocessingTileMemory", p, pOptions->noisy_run); break; }
+      pOptions->postproc_tile_memory = std::atof(s[1]); // <= 0 -> rasters are read in full
+      break;
+    }
     case(500):
     {/*:CreateRavenProfiles*/
       if (pOptions->noisy_run) { std::cout << "Writing Raven Profiles file (channel_properties_blackbird.rvp)" << std::endl; }
@@ -5,14 +5,16 @@
 CRaster::CRaster()
   : CGriddedData(),
   proj(nullptr),
-  datatype(GDT_Unknown) {
+  datatype(GDT_Unknown),
+  dataset(nullptr) {
   std::fill(std::begin(geotrans), std::end(geotrans), PLACEHOLDER);
 }
 
 // Copy constructor
 CRaster::CRaster(const CRaster &other)
   : CGriddedData(other),
-  datatype(other.datatype) {
+  datatype(other.datatype),
+  dataset(nullptr) { // the copy does not share the dataset of a streamed raster
 
   std::copy(std::begin(other.geotrans), std::end(other.geotrans), std::begin(geotrans));
   if (other.proj != nullptr) {
@@ -46,8 +48,61 @@ CRaster& CRaster::operator=(const CRaster &other) {
   return *this;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Returns the GDAL datatype of cell_type, which data is read and written as
+//
+GDALDataType CRaster::cell_gdal_type() const {
+  switch (cell_type) {
+  case CELL_FLOAT32: return GDT_Float32;
+  case CELL_INT32: return GDT_Int32;
+  default: return GDT_Float64;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Reallocates data to hold "num_rows" rows of the raster, setting ysize to "num_rows"
+/// \param num_rows [in] number of rows to hold
+//
+void CRaster::ResizeRows(int num_rows) {
+  data = CPLRealloc(data, cell_bytes() * xsize * num_rows);
+  ysize = num_rows;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Reads rows of the streamed raster from dataset into data, replacing the rows previously held
+/// \param row_first [in] first row of the raster to read
+/// \param num_rows [in] number of rows to read
+//
+void CRaster::ReadRows(int row_first, int num_rows) {
+  ExitGracefullyIf(dataset == nullptr,
+                   ("Raster.cpp: ReadRows: raster " + name + " is not streamed from a dataset").c_str(),
+                   exitcode::RUNTIME_ERR);
+  ResizeRows(num_rows);
+  GDALRasterBand *band = dataset->GetRasterBand(1);
+  if (band->RasterIO(GF_Read, 0, row_first, xsize, num_rows, data, xsize, num_rows,
+                     cell_gdal_type(), 0, 0) != CE_None) {
+    ExitGracefully(("Raster.cpp: ReadRows: failed to read rows of raster " + name).c_str(), exitcode::RUNTIME_ERR);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Frees the rows held by a streamed raster, restoring ysize to that of the full raster
+//
+void CRaster::ReleaseRows() {
+  if (data) {
+    CPLFree(data);
+    data = nullptr;
+  }
+  if (dataset) {
+    ysize = dataset->GetRasterYSize();
+  }
+}
+
 CRaster::~CRaster() {
   if (proj) {
     delete[] proj;
   }
+  if (dataset) {
+    GDALClose(dataset);
+  }
 }
@@ -9,6 +9,7 @@ public:
   char *proj;                                                 // raster projection
   double geotrans[6];                                         // raster geo transform
   GDALDataType datatype;                                      // datatype of raster values
+  GDALDataset *dataset;                                       // open dataset of a raster streamed in rows, nullptr if read or written in full
 
   // Constructors and Destructor
   CRaster();
@@ -23,9 +24,20 @@ public:
     return std::make_unique<CRaster>(*this);
   }
 
+  // Member functions
+  GDALDataType cell_gdal_type() const;                        // GDAL datatype of cell_type, for reading and writing data
+
   // I/O Functions
   void WriteToFile(std::string filepath) override;            // defined in StandardOutput.cpp
   void pretty_print() const override;                         // defined in StandardOutput.cpp
+
+  // Streaming Functions
+  void ResizeRows(int num_rows);                              // reallocates data to hold num_rows rows
+  void ReadRows(int row_first, int num_rows);                 // reads num_rows rows of dataset from row_first into data
+  void ReleaseRows();                                         // frees data and restores ysize to that of dataset
+  void CreateFile(std::string filepath);                      // creates dataset at filepath to write rows of data to, defined in StandardOutput.cpp
+  void WriteRows(int row_first);                              // writes data to rows of dataset from row_first, defined in StandardOutput.cpp
+  void CloseFile();                                           // flushes and closes dataset, defined in StandardOutput.cpp
 };
 
 #endif
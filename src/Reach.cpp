@@ -10,9 +10,10 @@ CReach::CReach()
 /// \brief Compute basic flow properties
 ///
 /// \param flow [in] flow to be used in computations
+/// \param *mm [in/out] working state of streamnode to fill
 /// \param *&bbopt [in] Global model options information
 //
-void CReach::compute_basic_flow_properties(double flow, COptions *&bbopt) {
+void CReach::compute_basic_flow_properties(double flow, hydraulic_output *mm, COptions *&bbopt) {
   mm->flow = flow;
 
   // --- Zero‑flow exception block ---
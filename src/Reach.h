@@ -9,7 +9,7 @@ public:
   CReach();
 
   // Functions
-  void compute_basic_flow_properties(double flow, COptions *&bbopt); // computes flow properties for reach
+  void compute_basic_flow_properties(double flow, hydraulic_output *mm, COptions *&bbopt); // computes flow properties for reach
 
   void pretty_print() const; // defined in StandardOutput.cpp
 };
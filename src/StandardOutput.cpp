@@ -89,6 +89,9 @@ void CModel::WriteGriddedOutput()
   if (bbopt->interpolation_postproc_method == enum_ppi_method::NONE) {
     return;
   }
+  if (bbopt->postproc_tile_memory > 0) {
+    return; // streamed rasters are written during post processing
+  }
   switch (bbopt->out_format)
   {
   case (enum_gridded_format::RASTER):
@@ -97,7 +100,7 @@ void CModel::WriteGriddedOutput()
       std::cout << "Writing output to Raster files" << std::endl;
     }
     for (int i = 0; i < out_gridded.size(); i++) {
-      std::string filepath = FilenamePrepare("bb_results_depth_" + fp_names[i] + ".tif");
+      std::string filepath = FilenamePrepare("bb_results_depth_" + out_gridded[i]->fp_name + ".tif");
       out_gridded[i]->WriteToFile(filepath);
       if (!bbopt->silent_run) {
         std::cout << filepath << " successfully written" << std::endl;
@@ -244,15 +247,29 @@ void CModel::WriteGriddedOutput()
       }
 
       // Write the data values
-      if (layer->datatype == NC_DOUBLE) {
-        if (nc_put_var_double(ncid, data_varid[i], layer->data) != NC_NOERR) {
+      if (layer->datatype == NC_DOUBLE && layer->cell_type == CELL_FLOAT64) {
+        if (nc_put_var_double(ncid, data_varid[i], layer->cells<double>()) != NC_NOERR) {
+          ExitGracefully("StandardOutput.cpp: CModel::WriteGriddedOutput: Failed to write 'data' values of NetCDF file.", exitcode::RUNTIME_ERR);
+        }
+      } else if (layer->datatype == NC_DOUBLE) { // convert to double before writing
+        double *temp = static_cast<double *>(
+            CPLMalloc(sizeof(double) * layer->xsize * layer->ysize));
+        for (size_t i = 0; i < layer->xsize * layer->ysize; i++) {
+          temp[i] = layer->get_value(i);
+        }
+        if (nc_put_var_double(ncid, data_varid[i], temp) != NC_NOERR) {
+          ExitGracefully("StandardOutput.cpp: CModel::WriteGriddedOutput: Failed to write 'data' values of NetCDF file.", exitcode::RUNTIME_ERR);
+        }
+        CPLFree(temp);
+      } else if (layer->datatype == NC_FLOAT && layer->cell_type == CELL_FLOAT32) {
+        if (nc_put_var_float(ncid, data_varid[i], layer->cells<float>()) != NC_NOERR) {
           ExitGracefully("StandardOutput.cpp: CModel::WriteGriddedOutput: Failed to write 'data' values of NetCDF file.", exitcode::RUNTIME_ERR);
         }
       } else if (layer->datatype == NC_FLOAT) { // convert to float before writing
         float *temp = static_cast<float *>(
             CPLMalloc(sizeof(float) * layer->xsize * layer->ysize));
         for (size_t i = 0; i < layer->xsize * layer->ysize; i++) {
-          temp[i] = static_cast<float>(layer->data[i]);
+          temp[i] = static_cast<float>(layer->get_value(i));
         }
         if (nc_put_var_float(ncid, data_varid[i], temp) != NC_NOERR) {
           ExitGracefully("StandardOutput.cpp: CModel::WriteGriddedOutput: Failed to write 'data' values of NetCDF file.", exitcode::RUNTIME_ERR);
@@ -276,7 +293,7 @@ void CModel::WriteGriddedOutput()
       std::cout << "Writing output to PNG files embedded with metadata" << std::endl;
     }
     for (int i = 0; i < out_gridded.size(); i++) {
-      std::string filepath = FilenamePrepare("bb_results_depth_" + fp_names[i] + ".png");
+      std::string filepath = FilenamePrepare("bb_results_depth_" + out_gridded[i]->fp_name + ".png");
       out_gridded[i]->WriteToPng(filepath);
       if (!bbopt->silent_run) {
         std::cout << filepath << " successfully written" << std::endl;
@@ -301,14 +318,15 @@ void CGriddedData::WriteToPng(std::string filepath)
   // Compute min/max values of data
   double min_val = PLACEHOLDER, max_val = PLACEHOLDER;
   for (int i = 0; i < xsize * ysize; i++) {
-    if (std::isnan(data[i]) || data[i] == na_val) {
+    double value = get_value(i);
+    if (std::isnan(value) || value == na_val) {
       continue;
     }
-    if (data[i] < min_val || min_val == PLACEHOLDER) {
-      min_val = data[i];
+    if (value < min_val || min_val == PLACEHOLDER) {
+      min_val = value;
     }
-    if (data[i] > max_val || max_val == PLACEHOLDER) {
-      max_val = data[i];
+    if (value > max_val || max_val == PLACEHOLDER) {
+      max_val = value;
     }
   }
 
@@ -319,10 +337,11 @@ void CGriddedData::WriteToPng(std::string filepath)
     range = 1.;
   }
   for (int i = 0; i < xsize * ysize; i++) {
-    if (std::isnan(data[i]) || data[i] == na_val) {
+    double value = get_value(i);
+    if (std::isnan(value) || value == na_val) {
       data_norm[i] = 0;
     } else {
-      double norm = 255. * (data[i] - min_val) / range;
+      double norm = 255. * (value - min_val) / range;
       data_norm[i] = static_cast<uint8_t>(std::clamp(norm, 0., 255.));
     }
   }
@@ -464,6 +483,21 @@ void CGriddedData::WriteToPng(std::string filepath)
 /// \param filepath [in] the full filepath to write gridded data to
 //
 void CRaster::WriteToFile(std::string filepath)
+{
+  ExitGracefullyIf(data == nullptr,
+                   "StandardOutput.cpp: CRaster::WriteToFile: Raster "
+                   "information not complete",
+                   exitcode::RUNTIME_ERR);
+  CreateFile(filepath);
+  WriteRows(0);
+  CloseFile();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Creates a geotiff raster file for the raster, to which rows of data are written by WriteRows
+/// \param filepath [in] the full filepath to write gridded data to
+//
+void CRaster::CreateFile(std::string filepath)
 {
   // Set options
   char **papszOptions = NULL;
@@ -472,49 +506,66 @@ void CRaster::WriteToFile(std::string filepath)
   papszOptions = CSLSetNameValue(papszOptions, "BLOCKXSIZE", "256");
   papszOptions = CSLSetNameValue(papszOptions, "BLOCKYSIZE", "256");
 
-  // Create file and write data
+  // Create file
   GDALDriver *driver = GetGDALDriverManager()->GetDriverByName("GTiff");
   ExitGracefullyIf(
       driver == nullptr,
-      "StandardOutput.cpp: CRaster::WriteToFile: Failed to get GTiff driver.",
+      "StandardOutput.cpp: CRaster::CreateFile: Failed to get GTiff driver.",
       exitcode::RUNTIME_ERR);
   ExitGracefullyIf(xsize == PLACEHOLDER || ysize == PLACEHOLDER ||
-                       proj == PLACEHOLDER_STR.c_str() || data == nullptr ||
+                       proj == PLACEHOLDER_STR.c_str() ||
                        na_val == PLACEHOLDER ||
                        std::find(std::begin(geotrans), std::end(geotrans),
                                  PLACEHOLDER) != std::end(geotrans),
-                   "StandardOutput.cpp: CRaster::WriteToFile: Raster "
+                   "StandardOutput.cpp: CRaster::CreateFile: Raster "
                    "information not complete",
                    exitcode::RUNTIME_ERR);
-  GDALDataset *output_dataset = driver->Create(filepath.c_str(), xsize, ysize, 1, datatype, papszOptions);
-  ExitGracefullyIf(output_dataset == nullptr,
-                   "StandardOutput.cpp: CRaster::WriteToFile: Failed to create "
+  dataset = driver->Create(filepath.c_str(), xsize, ysize, 1, datatype, papszOptions);
+  ExitGracefullyIf(dataset == nullptr,
+                   "StandardOutput.cpp: CRaster::CreateFile: Failed to create "
                    "output raster file.",
                    exitcode::RUNTIME_ERR);
-  GDALRasterBand *output_band = output_dataset->GetRasterBand(1);
+  GDALRasterBand *output_band = dataset->GetRasterBand(1);
   if (output_band->SetNoDataValue(na_val) != CE_None) {
-    ExitGracefully("StandardOutput.cpp: CRaster::WriteToFile: Failed to set no data value", exitcode::RUNTIME_ERR);
+    ExitGracefully("StandardOutput.cpp: CRaster::CreateFile: Failed to set no data value", exitcode::RUNTIME_ERR);
   }
-  if (output_band->RasterIO(GF_Write, 0, 0, xsize, ysize, data, xsize, ysize, GDT_Float64, 0, 0) != CE_None) {
-    ExitGracefully("StandardOutput.cpp: CRaster::WriteToFile: Failed to write raster data", exitcode::RUNTIME_ERR);
+  if (dataset->SetProjection(proj) != CE_None) {
+    ExitGracefully("StandardOutput.cpp: CRaster::CreateFile: Failed to set projection", exitcode::RUNTIME_ERR);
   }
-  if (output_dataset->SetProjection(proj) != CE_None) {
-    ExitGracefully("StandardOutput.cpp: CRaster::WriteToFile: Failed to set projection", exitcode::RUNTIME_ERR);
+  if (dataset->SetGeoTransform(geotrans) != CE_None) {
+    ExitGracefully("StandardOutput.cpp: CRaster::CreateFile: Failed to set geo transform", exitcode::RUNTIME_ERR);
   }
-  if (output_dataset->SetGeoTransform(geotrans) != CE_None) {
-    ExitGracefully("StandardOutput.cpp: CRaster::WriteToFile: Failed to set geo transform", exitcode::RUNTIME_ERR);
+
+  // Cleanup
+  CSLDestroy(papszOptions);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes the ysize rows held in data to the dataset created by CreateFile
+/// \param row_first [in] row of the raster file to write the first row of data to
+//
+void CRaster::WriteRows(int row_first)
+{
+  GDALRasterBand *output_band = dataset->GetRasterBand(1);
+  if (output_band->RasterIO(GF_Write, 0, row_first, xsize, ysize, data, xsize, ysize, cell_gdal_type(), 0, 0) != CE_None) {
+    ExitGracefully("StandardOutput.cpp: CRaster::WriteRows: Failed to write raster data", exitcode::RUNTIME_ERR);
   }
+}
 
+//////////////////////////////////////////////////////////////////
+/// \brief Flushes and closes the dataset created by CreateFile
+//
+void CRaster::CloseFile()
+{
+  GDALRasterBand *output_band = dataset->GetRasterBand(1);
   if (output_band->FlushCache() != CE_None) {
-    ExitGracefully("StandardOutput.cpp: CRaster::WriteToFile: Failed to flush band cache", exitcode::RUNTIME_ERR);
+    ExitGracefully("StandardOutput.cpp: CRaster::CloseFile: Failed to flush band cache", exitcode::RUNTIME_ERR);
   }
-  if (output_dataset->FlushCache() != CE_None) {
-    ExitGracefully("StandardOutput.cpp: CRaster::WriteToFile: Failed to flush dataset cache", exitcode::RUNTIME_ERR);
+  if (dataset->FlushCache() != CE_None) {
+    ExitGracefully("StandardOutput.cpp: CRaster::CloseFile: Failed to flush dataset cache", exitcode::RUNTIME_ERR);
   }
-
-  // Cleanup
-  CSLDestroy(papszOptions);
-  GDALClose(output_dataset);
+  GDALClose(dataset);
+  dataset = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -617,8 +668,12 @@ void CNetCDFLayer::WriteToFile(std::string filepath) {
     ExitGracefully("StandardOutput.cpp: CNetCDFLayer::WriteToFile: Failed to write 'northing' data.", exitcode::RUNTIME_ERR);
   }
 
-  // Write the data values
-  if (nc_put_var_double(ncid, data_varid, data) != NC_NOERR) {
+  // Write the data values, as double
+  std::vector<double> values(cell_type == CELL_FLOAT64 ? 0 : (size_t)xsize * ysize);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = get_value(i);
+  }
+  if (nc_put_var_double(ncid, data_varid, cell_type == CELL_FLOAT64 ? cells<double>() : values.data()) != NC_NOERR) {
     ExitGracefully("StandardOutput.cpp: CNetCDFLayer::WriteToFile: Failed to write 'data' values.", exitcode::RUNTIME_ERR);
   }
 
@@ -694,6 +749,7 @@ void CGriddedData::pretty_print() const
   TESTOUTPUT << std::setw(35) << "X Dimension:" << xsize << std::endl;
   TESTOUTPUT << std::setw(35) << "Y Dimension:" << ysize << std::endl;
   TESTOUTPUT << std::setw(35) << "NA Value:" << na_val << std::endl;
+  TESTOUTPUT << std::setw(35) << "Cell Type:" << toString(cell_type) << std::endl;
   TESTOUTPUT.close();
 }
 
@@ -784,6 +840,7 @@ void COptions::pretty_print() const
   TESTOUTPUT << std::setw(35) << "DX:" << dx << std::endl;
   TESTOUTPUT << std::setw(35) << "Extrapolate Depth Table:" << (extrapolate_depth_table ? "True" : "False") << std::endl;
   TESTOUTPUT << std::setw(35) << "Num Extrapolation Points:" << num_extrapolation_points << std::endl;
+  TESTOUTPUT << std::setw(35) << "Resample Depth Step:" << resample_depth_step << std::endl;
   TESTOUTPUT << std::setw(35) << "Friction Slope Method:" << toString(friction_slope_method) << std::endl;
   TESTOUTPUT << std::setw(35) << "X-Section Conveyance Method:" << toString(xsection_conveyance_method) << std::endl;
   TESTOUTPUT << std::setw(35) << "Enforce Delta Leff:" << (enforce_delta_Leff ? "True" : "False") << std::endl;
@@ -803,6 +860,8 @@ void COptions::pretty_print() const
   TESTOUTPUT << std::setw(35) << "Interpolation Postproc Method:" << toString(interpolation_postproc_method) << std::endl;
   TESTOUTPUT << std::setw(35) << "DHand Postproc Method:" << toString(dhand_method) << std::endl;
   TESTOUTPUT << std::setw(35) << "Postproc Elev Corr Threshold:" << postproc_elev_corr_threshold << std::endl;
+  TESTOUTPUT << std::setw(35) << "Postproc Block Size:" << postproc_block_size << std::endl;
+  TESTOUTPUT << std::setw(35) << "Postproc Tile Memory (MB):" << postproc_tile_memory << std::endl;
   TESTOUTPUT << std::setw(35) << "Roughness Multiplier:" << roughness_multiplier << std::endl;
   TESTOUTPUT << std::setw(35) << "Blended Conveyance Weights:" << blended_conveyance_weights << std::endl;
   TESTOUTPUT << std::setw(35) << "Blended NC Weights:" << blended_nc_weights << std::endl;
@@ -812,6 +871,28 @@ void COptions::pretty_print() const
   TESTOUTPUT << std::setw(35) << "Input NetCDF File Name:" << in_nc_name << std::endl;
   TESTOUTPUT << std::setw(35) << "Write Catchment Json:" << (write_catchment_json ? "True" : "False") << std::endl;
   TESTOUTPUT << std::setw(35) << "Enable Exhaustive Solution:" << (enable_exhaustive ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Num Threads:" << num_threads << std::endl;
+  TESTOUTPUT << std::setw(35) << "Warm Start WSL:" << (warm_start_wsl ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Warm Start Window:" << warm_start_window << std::endl;
+  TESTOUTPUT << std::setw(35) << "Critical Depth Cache:" << (critical_depth_cache ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Critical Depth Cache Tolerance:" << critical_depth_cache_tol << std::endl;
+  TESTOUTPUT << std::setw(35) << "Write Solver Telemetry:" << (write_solver_telemetry ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Telemetry Top N:" << telemetry_top_n << std::endl;
+  TESTOUTPUT << std::setw(35) << "Normal Depth Rating:" << (normal_depth_rating ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Incremental Spill Flows:" << (incremental_spill_flows ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Spill Re-solve Flow Tolerance:" << spill_resolve_flow_tol << std::endl;
+  TESTOUTPUT << std::setw(35) << "Spill Re-solve Level Tolerance:" << spill_resolve_level_tol << std::endl;
+  TESTOUTPUT << std::setw(35) << "Spill Flow Acceleration:" << toString(spill_acceleration) << std::endl;
+  TESTOUTPUT << std::setw(35) << "Spill Anderson Depth:" << spill_anderson_depth << std::endl;
+  TESTOUTPUT << std::setw(35) << "Write Spill Convergence:" << (write_spill_convergence ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Ensemble Mode:" << (ensemble_mode ? "True" : "False") << std::endl;
+  TESTOUTPUT << std::setw(35) << "Ensemble Batch Size:" << ensemble_batch_size << std::endl;
+  TESTOUTPUT << std::setw(35) << "Ensemble Quantiles:";
+  for (double q : ensemble_quantiles) {
+    TESTOUTPUT << q << " ";
+  }
+  TESTOUTPUT << std::endl;
+  TESTOUTPUT << std::setw(35) << "Ensemble Exceedance Depth:" << ensemble_exceedance_depth << std::endl;
   TESTOUTPUT << std::setw(35) << "Silent Run:" << (silent_run ? "True" : "False") << std::endl;
   TESTOUTPUT << std::setw(35) << "Noisy Run:" << (noisy_run ? "True" : "False") << std::endl;
   TESTOUTPUT << "===========================================\n" << std::endl;
@@ -1390,6 +1471,139 @@ void CModel::hyd_result_pretty_print_csv() const
   HYD_OUTPUT.close();
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Writes solver telemetry of each streamnode and flow profile to csv, along with a summary
+/// of the streamnodes that took the most wall time across all flow profiles
+/// \note wall times are measured per streamnode solve and include time spent waiting on shared
+/// critical depth curves, so shares are indicative only when multiple threads are used
+//
+void CModel::write_solver_telemetry() const
+{
+  if (sn_telemetry.empty()) {
+    WriteWarning("write_solver_telemetry: no solver telemetry was recorded", bbopt->noisy_run);
+    return;
+  }
+
+  std::string tmpFilename = FilenamePrepare("SolverTelemetry.csv");
+  std::ofstream TELEMETRY;
+  TELEMETRY.open(tmpFilename.c_str());
+  if (TELEMETRY.fail()) {
+    ExitGracefully(
+        ("CModel::write_solver_telemetry: Unable to open output file " +
+         tmpFilename + " for writing.")
+            .c_str(),
+        FILE_OPEN_ERR);
+  }
+
+  int num_sn = bbsn->size();
+  int num_fp = sn_telemetry.size() / num_sn;
+  std::vector<double> sn_wall_time(num_sn, 0.0);
+  double total_wall_time = 0.0;
+
+  TELEMETRY << "nodeId" << "," << "flowProfile" << "," << "solverPath" << ","
+            << "numSolves" << "," << "residualEvals" << "," << "energyEvals" << ","
+            << "bracketExpansions" << "," << "criticalFallbacks" << "," << "wallTimeMs"
+            << std::endl;
+  for (int f = 0; f < num_fp; f++) {
+    for (int i = 0; i < num_sn; i++) {
+      const solver_telemetry &tm = sn_telemetry[f * num_sn + i];
+      if (tm.num_solves == 0) {
+        continue;
+      }
+      TELEMETRY << (*bbsn)[i]->nodeID << "," << fp_names[f] << "," << toString(tm.path) << ","
+                << tm.num_solves << "," << tm.residual_evals << "," << tm.energy_evals << ","
+                << tm.bracket_expansions << "," << tm.critical_fallbacks << ","
+                << tm.wall_time * 1000.0 << std::endl;
+      sn_wall_time[i] += tm.wall_time;
+      total_wall_time += tm.wall_time;
+    }
+  }
+  TELEMETRY.close();
+
+  // rank streamnodes by wall time summed over all flow profiles
+  std::vector<int> order(num_sn);
+  for (int i = 0; i < num_sn; i++) {
+    order[i] = i;
+  }
+  int top_n = std::min(std::max(bbopt->telemetry_top_n, 0), num_sn);
+  std::partial_sort(order.begin(), order.begin() + top_n, order.end(),
+                    [&](int a, int b) { return sn_wall_time[a] > sn_wall_time[b]; });
+
+  tmpFilename = FilenamePrepare("SolverTelemetrySummary.csv");
+  std::ofstream SUMMARY;
+  SUMMARY.open(tmpFilename.c_str());
+  if (SUMMARY.fail()) {
+    ExitGracefully(
+        ("CModel::write_solver_telemetry: Unable to open output file " +
+         tmpFilename + " for writing.")
+            .c_str(),
+        FILE_OPEN_ERR);
+  }
+  SUMMARY << "rank" << "," << "nodeId" << "," << "wallTimeMs" << "," << "shareOfTotal" << std::endl;
+  if (!bbopt->silent_run) {
+    std::cout << "Streamnodes with the highest solver wall time (" << total_wall_time * 1000.0
+              << " ms total):" << std::endl;
+  }
+  for (int r = 0; r < top_n; r++) {
+    int i = order[r];
+    double share = total_wall_time > 0.0 ? sn_wall_time[i] / total_wall_time : 0.0;
+    SUMMARY << r + 1 << "," << (*bbsn)[i]->nodeID << "," << sn_wall_time[i] * 1000.0 << ","
+            << share << std::endl;
+    if (!bbopt->silent_run) {
+      std::cout << "  " << r + 1 << ". streamnode " << (*bbsn)[i]->nodeID << ": "
+                << sn_wall_time[i] * 1000.0 << " ms (" << share * 100.0 << "%)" << std::endl;
+    }
+  }
+  SUMMARY.close();
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Writes the mean, range, quantiles and exceedance count of the depths of all ensemble members
+/// at each streamnode to csv
+/// \note quantiles are the member depths of nearest rank, as used for the quantile flow profiles
+//
+void CModel::write_ensemble_statistics() const
+{
+  int num_members = ens_member_names.size();
+  int num_sn = bbsn->size();
+  if (num_members == 0 || ens_depths.size() != (long)num_sn * num_members) {
+    WriteWarning("write_ensemble_statistics: no ensemble results were computed", bbopt->noisy_run);
+    return;
+  }
+
+  std::string tmpFilename = FilenamePrepare("EnsembleStatistics.csv");
+  std::ofstream ENSEMBLE;
+  ENSEMBLE.open(tmpFilename.c_str());
+  if (ENSEMBLE.fail()) {
+    ExitGracefully(
+        ("CModel::write_ensemble_statistics: Unable to open output file " +
+         tmpFilename + " for writing.")
+            .c_str(),
+        FILE_OPEN_ERR);
+  }
+
+  ENSEMBLE << "nodeId" << "," << "numMembers" << "," << "meanDepth" << "," << "minDepth" << "," << "maxDepth";
+  for (int q = 0; q < bbopt->ensemble_quantiles.size(); q++) {
+    ENSEMBLE << "," << "depth_" << fp_names[q];
+  }
+  ENSEMBLE << "," << "exceedanceCount" << std::endl;
+  for (int i = 0; i < num_sn; i++) {
+    const float *depths = &ens_depths[(long)i * num_members]; // sorted by compute_ensemble
+    double sum = 0.0;
+    for (int m = 0; m < num_members; m++) {
+      sum += depths[m];
+    }
+    long num_exceeding = num_members - (std::upper_bound(depths, depths + num_members, bbopt->ensemble_exceedance_depth) - depths);
+    ENSEMBLE << (*bbsn)[i]->nodeID << "," << num_members << "," << sum / num_members << ","
+             << depths[0] << "," << depths[num_members - 1];
+    for (double q : bbopt->ensemble_quantiles) {
+      ENSEMBLE << "," << depths[(int)std::lround(q * (num_members - 1))];
+    }
+    ENSEMBLE << "," << num_exceeding << std::endl;
+  }
+  ENSEMBLE.close();
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Modifies catchments from streamnodes json file to include depths, flows, and wsls for each flowprofile
 /// \note Useful for compliance with the expected format of BlackbirdView
@@ -22,13 +22,14 @@ CStreamnode::CStreamnode()
   bed_slope(PLACEHOLDER),
   sn_roughness_multiplier(1.),
   depthdf(new std::vector<hydraulic_output*>),
+  hydtable(),
+  ndrating(),
   upstream_flows(),
   flow_sources(),
   flow_sinks(),
   output_flows(),
   output_depths(),
-  output_wsls(),
-  mm(new hydraulic_output) {
+  output_wsls() {
 }
 
 // Copy constructor
@@ -50,13 +51,14 @@ CStreamnode::CStreamnode(const CStreamnode& other)
   bed_slope(other.bed_slope),
   sn_roughness_multiplier(other.sn_roughness_multiplier),
   depthdf(new std::vector<hydraulic_output*>),
+  hydtable(other.hydtable),
+  ndrating(other.ndrating),
   upstream_flows(other.upstream_flows),
   flow_sources(other.flow_sources),
   flow_sinks(other.flow_sinks),
   output_flows(other.output_flows),
   output_depths(other.output_depths),
-  output_wsls(other.output_wsls),
-  mm(new hydraulic_output(*(other.mm))) {
+  output_wsls(other.output_wsls) {
   if (other.depthdf) {
     for (auto ptr : *other.depthdf) {
       depthdf->push_back(new hydraulic_output(*ptr));
@@ -86,13 +88,14 @@ CStreamnode &CStreamnode::operator=(const CStreamnode &other) {
   min_elev = other.min_elev;
   bed_slope = other.bed_slope;
   sn_roughness_multiplier = other.sn_roughness_multiplier;
+  hydtable = other.hydtable;
+  ndrating = other.ndrating;
   upstream_flows = other.upstream_flows;
   flow_sources = other.flow_sources;
   flow_sinks = other.flow_sinks;
   output_flows = other.output_flows;
   output_depths = other.output_depths;
   output_wsls = other.output_wsls;
-  mm = other.mm;
 
   // Delete existing depthdf contents
   if (depthdf) {
@@ -117,6 +120,8 @@ CStreamnode &CStreamnode::operator=(const CStreamnode &other) {
 
 //////////////////////////////////////////////////////////////////
 /// \brief Compute wsl based on parameters and streamnode member variables
+/// \note if ndrating has been built, the wsl is looked up from it and the iterative solution
+/// is only used for flows outside of the rating
 ///
 /// \param flow [in] flow to be used in computations
 /// \param slope [in] slope to be used in computations
@@ -125,25 +130,29 @@ CStreamnode &CStreamnode::operator=(const CStreamnode &other) {
 /// \return wsl value computed
 //
 double CStreamnode::compute_normal_depth(double flow, double slope, double init_wsl, COptions *bbopt) {
-  CStreamnode dupe = *this;
   if (init_wsl == -99) {
-    init_wsl = dupe.mm->min_elev + 1;
+    init_wsl = min_elev + 1;
   }
 
   static constexpr double FLOW_TOL = 1e-6; // xxx to do make global
 
-  if (flow < FLOW_TOL || (bbopt->skip_headwater && mm->upnodeID1==-1 )) {
+  if (flow < FLOW_TOL || (bbopt->skip_headwater && upnodeID1==-1 )) {
     // for zero flow, return the min elev
-    return dupe.mm->min_elev;
+    return min_elev;
+  }
+
+  if (!ndrating.wsl.empty()) {
+    double rated_wsl = lookup_normal_depth(flow, slope);
+    if (rated_wsl != PLACEHOLDER) {
+      return rated_wsl;
+    }
   }
   
-  dupe.compute_profile(flow, init_wsl, bbopt);
-  dupe.mm->sf = slope;
-  dupe.mm->sf_avg = slope;
+  hydraulic_state hs = evaluate_profile(init_wsl, flow, bbopt);
 
   double err_lag1 = PLACEHOLDER,
          err_lag2 = PLACEHOLDER,
-         prevWSL_lag1 = dupe.mm->wsl,
+         prevWSL_lag1 = hs.wsl,
          prevWSL_lag2 = PLACEHOLDER;
   for (int i = 0; i < bbopt->iteration_limit_nd; i++) {
     if (!bbopt->silent_run && i % 10 == 0) {
@@ -155,21 +164,19 @@ double CStreamnode::compute_normal_depth(double flow, double slope, double init_
       max_depth_change = 50;
     } else {
       prevWSL_lag2 = prevWSL_lag1;
-      prevWSL_lag1 = dupe.mm->wsl;
-      max_depth_change = 0.5 * (0.5 * (prevWSL_lag2 + prevWSL_lag1 - 2. * dupe.mm->min_elev));
+      prevWSL_lag1 = hs.wsl;
+      max_depth_change = 0.5 * (0.5 * (prevWSL_lag2 + prevWSL_lag1 - 2. * min_elev));
 
-      dupe.compute_profile(flow, dupe.mm->wsl, bbopt);
-      dupe.mm->sf = slope;
-      dupe.mm->sf_avg = slope;
+      hs = evaluate_profile(hs.wsl, flow, bbopt);
     }
 
-    double rhs = dupe.mm->k_total * std::sqrt(slope);
-    double comp_wsl = dupe.mm->min_elev + ((dupe.mm->depth * flow) / rhs);
+    double rhs = hs.k_total * std::sqrt(slope);
+    double comp_wsl = min_elev + ((hs.depth * flow) / rhs);
 
-    if (comp_wsl <= dupe.mm->min_elev) {
-      comp_wsl = dupe.mm->flow == 0
-                    ? dupe.mm->min_elev
-                    : std::max(dupe.mm->min_elev + 0.1, comp_wsl);
+    if (comp_wsl <= min_elev) {
+      comp_wsl = hs.flow == 0
+                    ? min_elev
+                    : std::max(min_elev + 0.1, comp_wsl);
     }
 
     err_lag2 = err_lag1;
@@ -187,41 +194,42 @@ double CStreamnode::compute_normal_depth(double flow, double slope, double init_
 
       double proposed_wsl = PLACEHOLDER;
       if (i == 0) {
-        proposed_wsl = dupe.mm->wsl + 0.7 * err_lag1;
-        dupe.mm->wsl = std::abs(proposed_wsl - dupe.mm->wsl) > max_depth_change
-                      ? dupe.mm->wsl + (proposed_wsl - dupe.mm->wsl) * (max_depth_change / std::abs(proposed_wsl - dupe.mm->wsl))
+        proposed_wsl = hs.wsl + 0.7 * err_lag1;
+        hs.wsl = std::abs(proposed_wsl - hs.wsl) > max_depth_change
+                      ? hs.wsl + (proposed_wsl - hs.wsl) * (max_depth_change / std::abs(proposed_wsl - hs.wsl))
                       : proposed_wsl;
       } else {
         if (std::abs(err_diff) < 0.003 || i >= ((double)bbopt->iteration_limit_nd) / 2 || i >= 20) {
           proposed_wsl = std::abs(comp_wsl - prevWSL_lag1) > max_depth_change
                             ? prevWSL_lag1 + std::copysign(0.5 * max_depth_change, comp_wsl - prevWSL_lag1)
                             : (comp_wsl + prevWSL_lag1) / 2;
-          dupe.mm->wsl = proposed_wsl;
+          hs.wsl = proposed_wsl;
         } else {
           proposed_wsl = prevWSL_lag2 - (err_lag2 * assum_diff) / err_diff;
-          dupe.mm->wsl = std::abs(proposed_wsl - dupe.mm->wsl) > max_depth_change
-                        ? dupe.mm->wsl + (proposed_wsl - dupe.mm->wsl) * (max_depth_change / std::abs(proposed_wsl - dupe.mm->wsl))
+          hs.wsl = std::abs(proposed_wsl - hs.wsl) > max_depth_change
+                        ? hs.wsl + (proposed_wsl - hs.wsl) * (max_depth_change / std::abs(proposed_wsl - hs.wsl))
                         : proposed_wsl;
         }
       }
-      dupe.mm->depth = dupe.mm->wsl - dupe.mm->min_elev;
+      hs.depth = hs.wsl - min_elev;
     } else {
       if (!bbopt->silent_run) {
         std::cout << "Normal depth estimated successfully." << std::endl;
       }
-      return dupe.mm->wsl;
+      return hs.wsl;
     }
   }
-  return dupe.mm->wsl;
+  return hs.wsl;
 }
 
 //////////////////////////////////////////////////////////////////
 /// \brief Compute basic depth properties with interpolation
 ///
 /// \param wsl [in] wsl to be used in computations
+/// \param *mm [in/out] working state of streamnode to fill
 /// \param *&bbopt [in] Global model options information
 //
-void CStreamnode::compute_basic_depth_properties_interpolation(double wsl, COptions*& bbopt) {
+void CStreamnode::compute_basic_depth_properties_interpolation(double wsl, hydraulic_output *mm, COptions*& bbopt) {
   ExitGracefullyIf(
       depthdf->size() == 0,
       "Streamnode.cpp: compute_basic_depth_properties_interpolation: depthdf "
@@ -234,12 +242,13 @@ void CStreamnode::compute_basic_depth_properties_interpolation(double wsl, COpti
       "Streamnode.cpp: compute_basic_depth_properties_interpolation: check "
       "properties in :PreprocHydTable do not match those in :Streamnodes table",
       exitcode::BAD_DATA);
+  ExitGracefullyIf(
+      hydtable.wsl.empty(),
+      "Streamnode.cpp: compute_basic_depth_properties_interpolation: hydtable "
+      "has not been built from depthdf.",
+      exitcode::RUNTIME_ERR);
   static constexpr double DEPTH_TOL = 1e-6; // xxx to do make global
-  std::vector<double> vec_depthdf_wsl = hyd_out_collect(&hydraulic_output::wsl, *depthdf);
-  std::valarray<double> val_depthdf_wsl(vec_depthdf_wsl.data(), vec_depthdf_wsl.size());
-  //std::cout << wsl << " | " << val_depthdf_wsl.min() << " | "
-  //          << val_depthdf_wsl.max() << std::endl;
-  if (wsl < val_depthdf_wsl.min() || wsl > val_depthdf_wsl.max()) {
+  if (wsl < hydtable.wsl_min || wsl > hydtable.wsl_max) {
     ExitGracefullyIf(
         !bbopt->extrapolate_depth_table,
         "Streamnode.cpp: compute_basic_depth_properties_interpolation: wsl "
@@ -249,107 +258,61 @@ void CStreamnode::compute_basic_depth_properties_interpolation(double wsl, COpti
         "Streamnode.cpp: compute_basic_depth_properties_interpolation: wsl "
         "provided (" +
             std::to_string(wsl) + ") is outside of the range in depthdf [" +
-            std::to_string(val_depthdf_wsl.min()) + ", " +
-            std::to_string(val_depthdf_wsl.max()) + "] in calculating flow " +
+            std::to_string(hydtable.wsl_min) + ", " +
+            std::to_string(hydtable.wsl_max) + "] in calculating flow " +
             std::to_string(mm->flow) +
             ",\nExtrapolating to continue computation.",
         bbopt->noisy_run);*/
-    mm->depth = wsl - mm->min_elev;
-        if (mm->depth <= DEPTH_TOL || (bbopt->skip_headwater && mm->upnodeID1==-1 ) ) {
-        mm->depth = 0.0;
-        mm->k_total = 0.0;
-        mm->alpha = 0.0;
-        mm->area = 0.0;
-        mm->hradius = 0.0;
-        mm->wet_perimeter = 0.0;
-        mm->manning_composite = 0.0;
-        mm->length_effective = 0.0;
-        mm->hyd_depth = 0.0;
-        mm->top_width = 0.0;
-        mm->k_total_areaconv = 0.0;
-        mm->k_total_disconv = 0.0;
-        mm->k_total_roughconv = 0.0;
-        mm->alpha_areaconv = 0.0;
-        mm->alpha_disconv = 0.0;
-        mm->alpha_roughconv = 0.0;
-        mm->nc_equalforce = 0.0;
-        mm->nc_equalvelocity = 0.0;
-        mm->nc_wavgwp = 0.0;
-        mm->nc_wavgarea = 0.0;
-        mm->nc_wavgconv = 0.0;
-        mm->length_effectiveadjusted = 0.0;
-
-        return;
-    }
-    mm->k_total = extrapolate(wsl, &hydraulic_output::k_total, *depthdf);
-    mm->alpha = extrapolate(wsl, &hydraulic_output::alpha, *depthdf);
-    mm->area = extrapolate(wsl, &hydraulic_output::area, *depthdf);
-    mm->hradius = extrapolate(wsl, &hydraulic_output::hradius, *depthdf);
-    mm->wet_perimeter = extrapolate(wsl, &hydraulic_output::wet_perimeter, *depthdf);
-    mm->manning_composite = extrapolate(wsl, &hydraulic_output::manning_composite, *depthdf);
-    mm->length_effective = extrapolate(wsl, &hydraulic_output::length_effective, *depthdf);
-    mm->hyd_depth = extrapolate(wsl, &hydraulic_output::hyd_depth, *depthdf);
-    mm->top_width = extrapolate(wsl, &hydraulic_output::top_width, *depthdf);
-    mm->k_total_areaconv = extrapolate(wsl, &hydraulic_output::k_total_areaconv, *depthdf);
-    mm->k_total_disconv = extrapolate(wsl, &hydraulic_output::k_total_disconv, *depthdf);
-    mm->k_total_roughconv = extrapolate(wsl, &hydraulic_output::k_total_roughconv, *depthdf);
-    mm->alpha_areaconv = extrapolate(wsl, &hydraulic_output::alpha_areaconv, *depthdf);
-    mm->alpha_disconv = extrapolate(wsl, &hydraulic_output::alpha_disconv, *depthdf);
-    mm->alpha_roughconv = extrapolate(wsl, &hydraulic_output::alpha_roughconv, *depthdf);
-    mm->nc_equalforce = extrapolate(wsl, &hydraulic_output::nc_equalforce, *depthdf);
-    mm->nc_equalvelocity = extrapolate(wsl, &hydraulic_output::nc_equalvelocity, *depthdf);
-    mm->nc_wavgwp = extrapolate(wsl, &hydraulic_output::nc_wavgwp, *depthdf);
-    mm->nc_wavgarea = extrapolate(wsl, &hydraulic_output::nc_wavgarea, *depthdf);
-    mm->nc_wavgconv = extrapolate(wsl, &hydraulic_output::nc_wavgconv, *depthdf);
-  } else {
-    mm->depth = wsl - mm->min_elev;
-    // --- Zero‑depth tolerance rule ---
-    if (mm->depth <= DEPTH_TOL || (bbopt->skip_headwater && mm->upnodeID1==-1 )) {
-        mm->depth = 0.0;
-        mm->k_total = 0.0;
-        mm->alpha = 0.0;
-        mm->area = 0.0;
-        mm->hradius = 0.0;
-        mm->wet_perimeter = 0.0;
-        mm->manning_composite = 0.0;
-        mm->length_effective = 0.0;
-        mm->hyd_depth = 0.0;
-        mm->top_width = 0.0;
-        mm->k_total_areaconv = 0.0;
-        mm->k_total_disconv = 0.0;
-        mm->k_total_roughconv = 0.0;
-        mm->alpha_areaconv = 0.0;
-        mm->alpha_disconv = 0.0;
-        mm->alpha_roughconv = 0.0;
-        mm->nc_equalforce = 0.0;
-        mm->nc_equalvelocity = 0.0;
-        mm->nc_wavgwp = 0.0;
-        mm->nc_wavgarea = 0.0;
-        mm->nc_wavgconv = 0.0;
-        mm->length_effectiveadjusted = 0.0;
-        return;
-    }
-    mm->k_total = interpolate(wsl, &hydraulic_output::k_total, *depthdf);
-    mm->alpha = interpolate(wsl, &hydraulic_output::alpha, *depthdf);
-    mm->area = interpolate(wsl, &hydraulic_output::area, *depthdf);
-    mm->hradius = interpolate(wsl, &hydraulic_output::hradius, *depthdf);
-    mm->wet_perimeter = interpolate(wsl, &hydraulic_output::wet_perimeter, *depthdf);
-    mm->manning_composite = interpolate(wsl, &hydraulic_output::manning_composite, *depthdf);
-    mm->length_effective = interpolate(wsl, &hydraulic_output::length_effective, *depthdf);
-    mm->hyd_depth = interpolate(wsl, &hydraulic_output::hyd_depth, *depthdf);
-    mm->top_width = interpolate(wsl, &hydraulic_output::top_width, *depthdf);
-    mm->k_total_areaconv = interpolate(wsl, &hydraulic_output::k_total_areaconv, *depthdf);
-    mm->k_total_disconv = interpolate(wsl, &hydraulic_output::k_total_disconv, *depthdf);
-    mm->k_total_roughconv = interpolate(wsl, &hydraulic_output::k_total_roughconv, *depthdf);
-    mm->alpha_areaconv = interpolate(wsl, &hydraulic_output::alpha_areaconv, *depthdf);
-    mm->alpha_disconv = interpolate(wsl, &hydraulic_output::alpha_disconv, *depthdf);
-    mm->alpha_roughconv = interpolate(wsl, &hydraulic_output::alpha_roughconv, *depthdf);
-    mm->nc_equalforce = interpolate(wsl, &hydraulic_output::nc_equalforce, *depthdf);
-    mm->nc_equalvelocity = interpolate(wsl, &hydraulic_output::nc_equalvelocity, *depthdf);
-    mm->nc_wavgwp = interpolate(wsl, &hydraulic_output::nc_wavgwp, *depthdf);
-    mm->nc_wavgarea = interpolate(wsl, &hydraulic_output::nc_wavgarea, *depthdf);
-    mm->nc_wavgconv = interpolate(wsl, &hydraulic_output::nc_wavgconv, *depthdf);
   }
+  mm->depth = wsl - mm->min_elev;
+  // --- Zero-depth tolerance rule ---
+  if (mm->depth <= DEPTH_TOL || (bbopt->skip_headwater && mm->upnodeID1==-1 )) {
+    mm->depth = 0.0;
+    mm->k_total = 0.0;
+    mm->alpha = 0.0;
+    mm->area = 0.0;
+    mm->hradius = 0.0;
+    mm->wet_perimeter = 0.0;
+    mm->manning_composite = 0.0;
+    mm->length_effective = 0.0;
+    mm->hyd_depth = 0.0;
+    mm->top_width = 0.0;
+    mm->k_total_areaconv = 0.0;
+    mm->k_total_disconv = 0.0;
+    mm->k_total_roughconv = 0.0;
+    mm->alpha_areaconv = 0.0;
+    mm->alpha_disconv = 0.0;
+    mm->alpha_roughconv = 0.0;
+    mm->nc_equalforce = 0.0;
+    mm->nc_equalvelocity = 0.0;
+    mm->nc_wavgwp = 0.0;
+    mm->nc_wavgarea = 0.0;
+    mm->nc_wavgconv = 0.0;
+    mm->length_effectiveadjusted = 0.0;
+    return;
+  }
+  // single bracket search, shared by all interpolated (or extrapolated) properties
+  table_bracket bracket = find_table_bracket(wsl, hydtable);
+  mm->k_total = interpolate(bracket, &hydraulic_table::k_total, hydtable);
+  mm->alpha = interpolate(bracket, &hydraulic_table::alpha, hydtable);
+  mm->area = interpolate(bracket, &hydraulic_table::area, hydtable);
+  mm->hradius = interpolate(bracket, &hydraulic_table::hradius, hydtable);
+  mm->wet_perimeter = interpolate(bracket, &hydraulic_table::wet_perimeter, hydtable);
+  mm->manning_composite = interpolate(bracket, &hydraulic_table::manning_composite, hydtable);
+  mm->length_effective = interpolate(bracket, &hydraulic_table::length_effective, hydtable);
+  mm->hyd_depth = interpolate(bracket, &hydraulic_table::hyd_depth, hydtable);
+  mm->top_width = interpolate(bracket, &hydraulic_table::top_width, hydtable);
+  mm->k_total_areaconv = interpolate(bracket, &hydraulic_table::k_total_areaconv, hydtable);
+  mm->k_total_disconv = interpolate(bracket, &hydraulic_table::k_total_disconv, hydtable);
+  mm->k_total_roughconv = interpolate(bracket, &hydraulic_table::k_total_roughconv, hydtable);
+  mm->alpha_areaconv = interpolate(bracket, &hydraulic_table::alpha_areaconv, hydtable);
+  mm->alpha_disconv = interpolate(bracket, &hydraulic_table::alpha_disconv, hydtable);
+  mm->alpha_roughconv = interpolate(bracket, &hydraulic_table::alpha_roughconv, hydtable);
+  mm->nc_equalforce = interpolate(bracket, &hydraulic_table::nc_equalforce, hydtable);
+  mm->nc_equalvelocity = interpolate(bracket, &hydraulic_table::nc_equalvelocity, hydtable);
+  mm->nc_wavgwp = interpolate(bracket, &hydraulic_table::nc_wavgwp, hydtable);
+  mm->nc_wavgarea = interpolate(bracket, &hydraulic_table::nc_wavgarea, hydtable);
+  mm->nc_wavgconv = interpolate(bracket, &hydraulic_table::nc_wavgconv, hydtable);
   if (mm->length_effective == 0) {
     ExitGracefully(
         ("Streamnode.cpp: compute_basic_depth_properties_interpolation: "
@@ -452,9 +415,10 @@ void CStreamnode::compute_basic_depth_properties_interpolation(double wsl, COpti
 ///
 /// \param flow [in] flow to be used in computations
 /// \param wsl [in] wsl to be used in computations
+/// \param *mm [in/out] working state of streamnode to fill
 /// \param *&bbopt [in] Global model options information
 //
-void CStreamnode::compute_profile(double flow, double wsl, COptions *bbopt) {
+void CStreamnode::compute_profile(double flow, double wsl, hydraulic_output *mm, COptions *bbopt) {
   mm->flow = flow;
   mm->wsl = wsl;
   
@@ -471,8 +435,8 @@ void CStreamnode::compute_profile(double flow, double wsl, COptions *bbopt) {
 
   mm->depth = mm->wsl - mm->min_elev;
 
-  compute_basic_depth_properties_interpolation(mm->wsl, bbopt);
-  compute_basic_flow_properties(mm->flow, bbopt);
+  compute_basic_depth_properties_interpolation(mm->wsl, mm, bbopt);
+  compute_basic_flow_properties(mm->flow, mm, bbopt);
 }
 
 //////////////////////////////////////////////////////////////////
@@ -480,11 +444,12 @@ void CStreamnode::compute_profile(double flow, double wsl, COptions *bbopt) {
 ///
 /// \param flow [in] flow to be used in computations
 /// \param wsl [in] wsl to be used in computations
+/// \param *mm [in/out] working state of streamnode to fill
 /// \param down_mm [in] mm of downstream node
 /// \param *&bbopt [in] Global model options information
 //
-void CStreamnode::compute_profile_next(double flow, double wsl, hydraulic_output *down_mm, COptions *bbopt) {
-  compute_profile(flow, wsl, bbopt);
+void CStreamnode::compute_profile_next(double flow, double wsl, hydraulic_output *mm, hydraulic_output *down_mm, COptions *bbopt) {
+  compute_profile(flow, wsl, mm, bbopt);
 
   if (bbopt->reach_integration_method == enum_ri_method::EFFECTIVE_LENGTH) {
     double reach_length = 0;
@@ -550,8 +515,8 @@ void CStreamnode::compute_profile_next(double flow, double wsl, hydraulic_output
 /// \param *&bbopt [in] Global model options information
 /// \return total energy of streamnode
 //
-double CStreamnode::get_total_energy(double H, hydraulic_output *down_mm, COptions *&bbopt) {
-  compute_profile_next(mm->flow, H, down_mm, bbopt);
+double CStreamnode::get_total_energy(double H, hydraulic_output *mm, hydraulic_output *down_mm, COptions *&bbopt) {
+  compute_profile_next(mm->flow, H, mm, down_mm, bbopt);
   return energy_calc(mm->min_elev, mm->depth, mm->velocity, mm->alpha, GRAVITY);
 }
 
@@ -563,8 +528,8 @@ double CStreamnode::get_total_energy(double H, hydraulic_output *down_mm, COptio
 /// \param *&bbopt [in] Global model options information
 /// \return absolute difference in provided and computed WSL at streamnode (>=0)
 //
-double CStreamnode::get_wsl_error(double H, hydraulic_output *down_mm, COptions *&bbopt) {
-  compute_profile_next(mm->flow, H, down_mm, bbopt);
+double CStreamnode::get_wsl_error(double H, hydraulic_output *mm, hydraulic_output *down_mm, COptions *&bbopt) {
+  compute_profile_next(mm->flow, H, mm, down_mm, bbopt);
   return std::abs(H - (down_mm->wsl + down_mm->velocity_head + mm->head_loss -
               mm->velocity_head));
 }
@@ -579,9 +544,9 @@ double CStreamnode::get_wsl_error(double H, hydraulic_output *down_mm, COptions
 /// \param *&bbopt [in] Global model options information
 /// \return difference in provided and computed WSL at streamnode (>=0)
 //
-double CStreamnode::get_wsl_residual(double H, hydraulic_output *down_mm, COptions *&bbopt){
+double CStreamnode::get_wsl_residual(double H, hydraulic_output *mm, hydraulic_output *down_mm, COptions *&bbopt){
     // Update hydraulic state at this node for water surface level H
-    compute_profile_next(mm->flow, H, down_mm, bbopt);
+    compute_profile_next(mm->flow, H, mm, down_mm, bbopt);
     // Compute the target WSL based on downstream hydraulics
     double H_target = down_mm->wsl
                     + down_mm->velocity_head
@@ -591,6 +556,320 @@ double CStreamnode::get_wsl_residual(double H, hydraulic_output *down_mm, COptio
     return H - H_target;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Evaluate hydraulic state of streamnode for given wsl and flow
+/// \note stateless counterpart of compute_profile for use within solvers; mm is not modified
+/// and no heap allocation is performed
+///
+/// \param wsl [in] wsl to be used in computations
+/// \param flow [in] flow to be used in computations
+/// \param *bbopt [in] Global model options information
+/// \return hydraulic state of streamnode at wsl
+//
+hydraulic_state CStreamnode::evaluate_profile(double wsl, double flow, const COptions *bbopt) const {
+  hydraulic_state hs;
+  hs.flow = flow;
+  hs.wsl = wsl;
+
+  if (hs.flow <= bbopt->tolerance_nd || hs.wsl < min_elev) {
+    hs.wsl = min_elev;
+  }
+  hs.depth = hs.wsl - min_elev;
+
+  evaluate_depth_properties(hs, bbopt);
+  evaluate_flow_properties(hs);
+  return hs;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Evaluate hydraulic state of streamnode for given wsl and flow, including losses towards downstream node
+/// \note stateless counterpart of compute_profile_next for use within solvers; mm is not modified
+///
+/// \param wsl [in] wsl to be used in computations
+/// \param flow [in] flow to be used in computations
+/// \param *down_mm [in] mm of downstream node
+/// \param *bbopt [in] Global model options information
+/// \return hydraulic state of streamnode at wsl
+//
+hydraulic_state CStreamnode::evaluate_profile_next(double wsl, double flow, const hydraulic_output *down_mm, const COptions *bbopt) const {
+  hydraulic_state hs = evaluate_profile(wsl, flow, bbopt);
+
+  if (bbopt->reach_integration_method == enum_ri_method::EFFECTIVE_LENGTH) {
+    double reach_length = us_reach_length2 != -99 ? us_reach_length2 : us_reach_length1;
+    double leff_ratio = hs.length_effective / reach_length;
+    hs.d_sf = hs.d_sf * leff_ratio * leff_ratio + 2. * hs.sf * leff_ratio * hs.d_length_effective / reach_length;
+    hs.sf *= std::pow(hs.length_effective / reach_length, 2.0);
+  }
+
+  if (bbopt->friction_slope_method == enum_fs_method::AVERAGE_CONVEYANCE) {
+    if (hs.flow == PLACEHOLDER || down_mm->flow == PLACEHOLDER ||
+        hs.k_total == PLACEHOLDER || down_mm->k_total == PLACEHOLDER) {
+      hs.sf_avg = (hs.sf + down_mm->sf) / 2.;
+      hs.d_sf_avg = hs.d_sf / 2.;
+    } else {
+      hs.sf_avg = std::pow((hs.flow + down_mm->flow) / (hs.k_total + down_mm->k_total), 2.0);
+      hs.d_sf_avg = -2. * hs.sf_avg * hs.d_k_total / (hs.k_total + down_mm->k_total);
+    }
+  } else if (bbopt->friction_slope_method == enum_fs_method::AVERAGE_FRICTION) {
+    hs.sf_avg = (hs.sf + down_mm->sf) / 2.;
+    hs.d_sf_avg = hs.d_sf / 2.;
+  } else if (bbopt->friction_slope_method == enum_fs_method::GEOMETRIC_FRICTION) {
+    hs.sf_avg = std::sqrt(hs.sf * down_mm->sf);
+    hs.d_sf_avg = hs.sf_avg > 0 ? hs.d_sf * down_mm->sf / (2. * hs.sf_avg) : 0;
+  } else if (bbopt->friction_slope_method == enum_fs_method::HARMONIC_FRICTION) {
+    hs.sf_avg = 2. * hs.sf * down_mm->sf / (hs.sf + down_mm->sf);
+    hs.d_sf_avg = 2. * down_mm->sf * down_mm->sf * hs.d_sf / ((hs.sf + down_mm->sf) * (hs.sf + down_mm->sf));
+  } else if (bbopt->friction_slope_method == enum_fs_method::REACH_FRICTION) {
+    if (bbopt->regimetype == enum_rt_method::SUBCRITICAL) {
+      hs.sf_avg = down_mm->sf;
+      hs.d_sf_avg = 0;
+    } else {
+      hs.sf_avg = hs.sf;
+      hs.d_sf_avg = hs.d_sf;
+    }
+  }
+
+  double loss_coeff = down_mm->velocity_head > hs.velocity_head ? contraction_coeff : expansion_coeff;
+
+  if (bbopt->leff_method == enum_le_method::AVERAGE) {
+    hs.length_energyloss = (hs.length_effectiveadjusted + down_mm->length_effectiveadjusted) / 2.;
+    hs.d_length_energyloss = hs.d_length_effectiveadjusted / 2.;
+  } else if (bbopt->leff_method == enum_le_method::DOWNSTREAM) {
+    hs.length_energyloss = down_mm->length_effectiveadjusted;
+    hs.d_length_energyloss = 0;
+  } else if (bbopt->leff_method == enum_le_method::UPSTREAM) {
+    hs.length_energyloss = hs.length_effectiveadjusted;
+    hs.d_length_energyloss = hs.d_length_effectiveadjusted;
+  } else {
+    ExitGracefully("Streamnode.cpp: evaluate_profile_next: unrecognized leff_method", exitcode::BAD_DATA);
+  }
+
+  double vh_diff = ((hs.alpha * hs.velocity * hs.velocity / 2.) / GRAVITY) -
+                   ((down_mm->alpha * down_mm->velocity * down_mm->velocity / 2.) / GRAVITY);
+  hs.head_loss =
+      hs.length_energyloss * hs.sf_avg +
+      loss_coeff * std::abs(vh_diff);
+  hs.d_head_loss =
+      hs.d_length_energyloss * hs.sf_avg + hs.length_energyloss * hs.d_sf_avg +
+      loss_coeff * (vh_diff < 0 ? -hs.d_velocity_head : hs.d_velocity_head);
+  return hs;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Evaluate total energy of streamnode for given wsl without modifying streamnode
+///
+/// \param H [in] wsl value
+/// \param flow [in] flow to be used in computations
+/// \param *down_mm [in] mm of downstream node
+/// \param *bbopt [in] Global model options information
+/// \return total energy of streamnode
+//
+double CStreamnode::evaluate_total_energy(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt) const {
+  hydraulic_state hs = evaluate_profile_next(H, flow, down_mm, bbopt);
+  return energy_calc(min_elev, hs.depth, hs.velocity, hs.alpha, GRAVITY);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Evaluate total energy of streamnode and its derivative for given wsl without modifying streamnode
+///
+/// \param H [in] wsl value
+/// \param flow [in] flow to be used in computations
+/// \param *down_mm [in] mm of downstream node
+/// \param *bbopt [in] Global model options information
+/// \param &dEdH [out] derivative of the total energy with respect to H
+/// \return total energy of streamnode
+//
+double CStreamnode::evaluate_total_energy(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt, double &dEdH) const {
+  hydraulic_state hs = evaluate_profile_next(H, flow, down_mm, bbopt);
+  dEdH = (hs.depth > 0 ? 1. : 0.) + hs.d_velocity_head;
+  return energy_calc(min_elev, hs.depth, hs.velocity, hs.alpha, GRAVITY);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Evaluate signed residual in the WSL calculation without modifying streamnode
+///
+/// \param H [in] wsl value
+/// \param flow [in] flow to be used in computations
+/// \param *down_mm [in] mm of downstream node
+/// \param *bbopt [in] Global model options information
+/// \return difference in provided and computed WSL at streamnode
+//
+double CStreamnode::evaluate_wsl_residual(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt) const {
+  hydraulic_state hs = evaluate_profile_next(H, flow, down_mm, bbopt);
+  return H - (down_mm->wsl + down_mm->velocity_head + hs.head_loss - hs.velocity_head);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Evaluate signed residual in the WSL calculation and its derivative without modifying streamnode
+/// \note the derivative is analytic for the linear interpolation of the depth table, so it is exact
+/// between table rows and one-sided at a row
+///
+/// \param H [in] wsl value
+/// \param flow [in] flow to be used in computations
+/// \param *down_mm [in] mm of downstream node
+/// \param *bbopt [in] Global model options information
+/// \param &dRdH [out] derivative of the residual with respect to H
+/// \return difference in provided and computed WSL at streamnode
+//
+double CStreamnode::evaluate_wsl_residual(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt, double &dRdH) const {
+  hydraulic_state hs = evaluate_profile_next(H, flow, down_mm, bbopt);
+  dRdH = 1. - hs.d_head_loss + hs.d_velocity_head;
+  return H - (down_mm->wsl + down_mm->velocity_head + hs.head_loss - hs.velocity_head);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Fills depth properties of hydraulic state by interpolation of depthdf
+/// \note mirrors compute_basic_depth_properties_interpolation for the properties required by the solvers
+///
+/// \param &hs [in/out] hydraulic state with wsl and depth assigned
+/// \param *bbopt [in] Global model options information
+//
+void CStreamnode::evaluate_depth_properties(hydraulic_state &hs, const COptions *bbopt) const {
+  ExitGracefullyIf(
+      hydtable.wsl.size() == 0,
+      "Streamnode.cpp: evaluate_depth_properties: depthdf "
+      "has not been computed, please include it in a bbg file.",
+      exitcode::BAD_DATA);
+  static constexpr double DEPTH_TOL = 1e-6; // xxx to do make global
+
+  ExitGracefullyIf(
+      (hs.wsl < hydtable.wsl_min || hs.wsl > hydtable.wsl_max) && !bbopt->extrapolate_depth_table,
+      "Streamnode.cpp: evaluate_depth_properties: wsl "
+      "provided is outside of the range in depthdf",
+      exitcode::RUNTIME_ERR);
+
+  if (hs.depth <= DEPTH_TOL || (bbopt->skip_headwater && upnodeID1 == -1)) {
+    hs.depth = 0.0;
+    hs.k_total = 0.0;
+    hs.alpha = 0.0;
+    hs.area = 0.0;
+    hs.length_effective = 0.0;
+    hs.hyd_depth = 0.0;
+    hs.top_width = 0.0;
+    hs.length_effectiveadjusted = 0.0;
+    return;
+  }
+
+  table_bracket bracket = find_table_bracket(hs.wsl, hydtable);
+  hs.k_total = interpolate(bracket, &hydraulic_table::k_total, hydtable);
+  hs.alpha = interpolate(bracket, &hydraulic_table::alpha, hydtable);
+  hs.area = interpolate(bracket, &hydraulic_table::area, hydtable);
+  hs.length_effective = interpolate(bracket, &hydraulic_table::length_effective, hydtable);
+  hs.hyd_depth = interpolate(bracket, &hydraulic_table::hyd_depth, hydtable);
+  hs.top_width = interpolate(bracket, &hydraulic_table::top_width, hydtable);
+  hs.d_k_total = interpolate_slope(bracket, &hydraulic_table::k_total, hydtable);
+  hs.d_alpha = interpolate_slope(bracket, &hydraulic_table::alpha, hydtable);
+  hs.d_area = interpolate_slope(bracket, &hydraulic_table::area, hydtable);
+  hs.d_length_effective = interpolate_slope(bracket, &hydraulic_table::length_effective, hydtable);
+
+  if (hs.length_effective <= 0) {
+    ExitGracefully(
+        ("Streamnode.cpp: evaluate_depth_properties: "
+         "length_effective for " + std::to_string(nodeID) +
+         " was computed to be non-positive. Check :PreprocHydTable to ensure Length_Effective is >0.")
+            .c_str(),
+        exitcode::BAD_DATA);
+  }
+
+  hs.length_effectiveadjusted = hs.length_effective;
+  hs.d_length_effectiveadjusted = hs.d_length_effective;
+
+  if (bbopt->roughness_multiplier != 1) {
+    if (bbopt->roughness_multiplier == PLACEHOLDER ||
+        bbopt->roughness_multiplier <= 0) {
+      ExitGracefully("Streamnode.cpp: evaluate_depth_properties: "
+                     "bbopt->roughness_multiplier must be a positive value.",
+                     BAD_DATA);
+    }
+    hs.k_total /= bbopt->roughness_multiplier;
+    hs.d_k_total /= bbopt->roughness_multiplier;
+  }
+
+  if (sn_roughness_multiplier != 1) {
+    if (sn_roughness_multiplier == PLACEHOLDER ||
+        sn_roughness_multiplier <= 0) {
+      ExitGracefully("Streamnode.cpp: evaluate_depth_properties: "
+                     "sn_roughness_multiplier must be a positive value.",
+                     BAD_DATA);
+    }
+    hs.k_total /= sn_roughness_multiplier;
+    hs.d_k_total /= sn_roughness_multiplier;
+  }
+
+  double reach_length = us_reach_length2 != -99 ? us_reach_length2 : us_reach_length1;
+  if (reach_length <= 0) {
+    ExitGracefully(
+        ("Streamnode.cpp: evaluate_depth_properties: "
+         "reach_length for streamnode with nodeID " +
+         std::to_string(nodeID) +
+         " is a non-positive value. Cannot obtain depth properties")
+            .c_str(),
+        exitcode::BAD_DATA);
+  }
+
+  if (bbopt->enforce_delta_Leff) {
+    double leff_bound = PLACEHOLDER;
+    if (hs.length_effective < reach_length * (1 - bbopt->delta_reachlength)) {
+      leff_bound = reach_length * (1 - bbopt->delta_reachlength);
+    } else if (hs.length_effective > reach_length * (1 + bbopt->delta_reachlength)) {
+      leff_bound = reach_length * (1 + bbopt->delta_reachlength);
+    }
+    if (leff_bound != PLACEHOLDER) {
+      hs.length_effectiveadjusted = leff_bound;
+      hs.d_length_effectiveadjusted = 0.0;
+      if (bbopt->reach_integration_method == enum_ri_method::EFFECTIVE_LENGTH) {
+        double leff_ratio = hs.length_effectiveadjusted / hs.length_effective;
+        double d_leff_ratio = -leff_ratio * hs.d_length_effective / hs.length_effective;
+        hs.d_area = hs.d_area * leff_ratio + hs.area * d_leff_ratio;
+        hs.d_k_total = hs.d_k_total * leff_ratio + hs.k_total * d_leff_ratio;
+        hs.area *= leff_ratio;
+        hs.k_total *= leff_ratio;
+        hs.top_width *= leff_ratio;
+        hs.hyd_depth *= leff_ratio;
+      }
+    }
+  }
+
+  if (bbopt->reach_integration_method == enum_ri_method::EFFECTIVE_LENGTH) {
+    double leff_ratio = hs.length_effective / reach_length;
+    double d_leff_ratio = hs.d_length_effective / reach_length;
+    hs.d_area = hs.d_area * leff_ratio + hs.area * d_leff_ratio;
+    hs.d_k_total = hs.d_k_total * leff_ratio + hs.k_total * d_leff_ratio;
+    hs.area *= leff_ratio;
+    hs.k_total *= leff_ratio;
+    hs.top_width *= leff_ratio;
+    hs.hyd_depth *= leff_ratio;
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Fills flow properties of hydraulic state
+/// \note mirrors CReach::compute_basic_flow_properties, evaluated on the interpolated depth table for all node types
+///
+/// \param &hs [in/out] hydraulic state with depth properties assigned
+//
+void CStreamnode::evaluate_flow_properties(hydraulic_state &hs) const {
+  if (hs.flow == 0.0) {
+    hs.velocity = 0.0;
+    hs.velocity_head = 0.0;
+    hs.froude = 0.0;
+    hs.sf = 0.0;
+    return;
+  }
+
+  hs.velocity = hs.area != 0 && hs.flow / hs.area != DBL_MAX
+                    ? hs.flow / hs.area
+                    : 0;
+  hs.d_velocity = hs.velocity != 0 ? -hs.velocity * hs.d_area / hs.area : 0;
+  hs.velocity_head = (hs.alpha * hs.velocity * hs.velocity / 2.) / GRAVITY;
+  hs.d_velocity_head = (hs.d_alpha * hs.velocity * hs.velocity / 2. + hs.alpha * hs.velocity * hs.d_velocity) / GRAVITY;
+  hs.froude = hs.velocity / std::sqrt(GRAVITY * hs.hyd_depth);
+  hs.sf = hs.k_total != 0 && pow(hs.flow / hs.k_total, 2.) != DBL_MAX
+              ? pow(hs.flow / hs.k_total, 2.)
+              : 0;
+  hs.d_sf = hs.sf != 0 ? -2. * hs.sf * hs.d_k_total / hs.k_total : 0;
+}
+
 
 //////////////////////////////////////////////////////////////////
 /// \brief Add row to depthdf
@@ -602,6 +881,205 @@ void CStreamnode::add_depthdf_row(hydraulic_output*& row) {
   depthdf_map[row->depth] = depthdf->size() - 1;
 }
 
+//////////////////////////////////////////////////////////////////
+/// \brief Builds hydtable, the columnar copy of depthdf used for interpolation
+/// \note called once after all :PreprocHydTable rows have been added
+//
+void CStreamnode::build_hydtable() {
+  hydtable = hydraulic_table();
+  if (depthdf->empty()) {
+    return;
+  }
+
+  for (int i = 0; i < depthdf->size(); i++) {
+    const hydraulic_output *row = (*depthdf)[i];
+    if (i > 0 && row->wsl <= hydtable.wsl.back()) { // equal rows would bracket a zero width interval
+      ExitGracefully(("Streamnode.cpp: build_hydtable: rows of :PreprocHydTable for streamnode with nodeID " +
+                      std::to_string(nodeID) + " must be in strictly increasing order of depth")
+                         .c_str(),
+                     exitcode::BAD_DATA);
+    }
+    hydtable.wsl.push_back(row->wsl);
+    hydtable.depth.push_back(row->depth);
+    hydtable.k_total.push_back(row->k_total);
+    hydtable.alpha.push_back(row->alpha);
+    hydtable.area.push_back(row->area);
+    hydtable.hradius.push_back(row->hradius);
+    hydtable.wet_perimeter.push_back(row->wet_perimeter);
+    hydtable.manning_composite.push_back(row->manning_composite);
+    hydtable.length_effective.push_back(row->length_effective);
+    hydtable.hyd_depth.push_back(row->hyd_depth);
+    hydtable.top_width.push_back(row->top_width);
+    hydtable.k_total_areaconv.push_back(row->k_total_areaconv);
+    hydtable.k_total_disconv.push_back(row->k_total_disconv);
+    hydtable.k_total_roughconv.push_back(row->k_total_roughconv);
+    hydtable.alpha_areaconv.push_back(row->alpha_areaconv);
+    hydtable.alpha_disconv.push_back(row->alpha_disconv);
+    hydtable.alpha_roughconv.push_back(row->alpha_roughconv);
+    hydtable.nc_equalforce.push_back(row->nc_equalforce);
+    hydtable.nc_equalvelocity.push_back(row->nc_equalvelocity);
+    hydtable.nc_wavgwp.push_back(row->nc_wavgwp);
+    hydtable.nc_wavgarea.push_back(row->nc_wavgarea);
+    hydtable.nc_wavgconv.push_back(row->nc_wavgconv);
+  }
+  hydtable.wsl_min = hydtable.wsl.front();
+  hydtable.wsl_max = hydtable.wsl.back();
+
+  // flag uniformly spaced tables so that lookups skip the search
+  int n = (int)hydtable.wsl.size();
+  if (n < 2) {
+    return;
+  }
+  static constexpr double STEP_TOL = 1e-6; // relative tolerance on row spacing
+  double wsl_step = (hydtable.wsl_max - hydtable.wsl_min) / (n - 1);
+  double depth_step = (hydtable.depth.back() - hydtable.depth.front()) / (n - 1);
+  bool uniform_wsl = wsl_step > 0;
+  bool uniform_depth = depth_step > 0;
+  for (int i = 1; i < n; i++) {
+    uniform_wsl = uniform_wsl && std::abs(hydtable.wsl[i] - hydtable.wsl[i - 1] - wsl_step) <= STEP_TOL * wsl_step;
+    uniform_depth = uniform_depth && std::abs(hydtable.depth[i] - hydtable.depth[i - 1] - depth_step) <= STEP_TOL * depth_step;
+  }
+  hydtable.wsl_step = uniform_wsl ? wsl_step : PLACEHOLDER;
+  hydtable.depth_step = uniform_depth ? depth_step : PLACEHOLDER;
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Builds ndrating, the rating of wsl versus effective conveyance used for normal depth lookups
+/// \note each interval of hydtable is split into NORMAL_RATING_SUBDIV rating points, since the effective
+/// conveyance is not linear within an interval when scaled by the effective length. Must be called
+/// after hydtable is final (i.e., after any resampling)
+///
+/// \param *bbopt [in] Global model options information
+//
+void CStreamnode::build_normal_depth_rating(const COptions *bbopt) {
+  ndrating = normal_depth_rating();
+  int n = (int)hydtable.wsl.size();
+  if (n < 2) {
+    return;
+  }
+
+  ndrating.wsl.reserve((n - 1) * NORMAL_RATING_SUBDIV + 1);
+  ndrating.conveyance.reserve((n - 1) * NORMAL_RATING_SUBDIV + 1);
+  for (int i = 0; i < n - 1; i++) {
+    for (int j = 0; j < NORMAL_RATING_SUBDIV; j++) {
+      double wsl = hydtable.wsl[i] + (hydtable.wsl[i + 1] - hydtable.wsl[i]) * j / NORMAL_RATING_SUBDIV;
+      if (!ndrating.wsl.empty() && wsl <= ndrating.wsl.back()) {
+        continue; // repeated wsl rows in hydtable
+      }
+      ndrating.wsl.push_back(wsl);
+    }
+  }
+  if (hydtable.wsl_max > ndrating.wsl.back()) {
+    ndrating.wsl.push_back(hydtable.wsl_max);
+  }
+
+  // conveyance does not depend on flow; any flow above the zero flow tolerance is used
+  double flow = std::max(1.0, 2. * bbopt->tolerance_nd);
+  double k_max = 0.0;
+  for (double wsl : ndrating.wsl) {
+    k_max = std::max(k_max, evaluate_profile(wsl, flow, bbopt).k_total);
+    ndrating.conveyance.push_back(k_max);
+  }
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Looks up the normal depth wsl of a flow from ndrating
+/// \note the lowest wsl at which the rated conveyance reaches Q / sqrt(S) is returned
+///
+/// \param flow [in] flow to be used in computations
+/// \param slope [in] slope to be used in computations
+/// \return normal depth wsl, or PLACEHOLDER if the rating is empty or does not span the required conveyance
+//
+double CStreamnode::lookup_normal_depth(double flow, double slope) const {
+  if (ndrating.wsl.empty() || slope <= 0) {
+    return PLACEHOLDER;
+  }
+  double k_target = flow / std::sqrt(slope);
+  if (k_target > ndrating.conveyance.back()) {
+    return PLACEHOLDER;
+  }
+  int upper = (int)(std::lower_bound(ndrating.conveyance.begin(), ndrating.conveyance.end(), k_target) -
+                    ndrating.conveyance.begin());
+  if (upper == 0) {
+    return ndrating.conveyance[0] == k_target ? ndrating.wsl[0] : PLACEHOLDER;
+  }
+  int lower = upper - 1;
+  double frac = (k_target - ndrating.conveyance[lower]) /
+                (ndrating.conveyance[upper] - ndrating.conveyance[lower]);
+  return ndrating.wsl[lower] + frac * (ndrating.wsl[upper] - ndrating.wsl[lower]);
+}
+
+//////////////////////////////////////////////////////////////////
+/// \brief Resamples hydtable onto a uniform depth grid spanning the original table
+/// \note the grid spacing is the largest spacing no greater than depth_step that spans the table exactly.
+/// depthdf is left unchanged
+///
+/// \param depth_step [in] maximum spacing of the resampled depth grid
+/// \return maximum interpolation error at the original rows, relative to the largest magnitude of each property
+//
+double CStreamnode::resample_hydtable(double depth_step) {
+  ExitGracefullyIf(depth_step <= 0,
+                   "Streamnode.cpp: resample_hydtable: depth_step must be a positive value",
+                   exitcode::BAD_DATA);
+  if (hydtable.wsl.size() < 2) {
+    return 0.0;
+  }
+
+  static std::vector<double> hydraulic_table::* const columns[] = {
+      &hydraulic_table::depth, &hydraulic_table::k_total, &hydraulic_table::alpha,
+      &hydraulic_table::area, &hydraulic_table::hradius, &hydraulic_table::wet_perimeter,
+      &hydraulic_table::manning_composite, &hydraulic_table::length_effective,
+      &hydraulic_table::hyd_depth, &hydraulic_table::top_width,
+      &hydraulic_table::k_total_areaconv, &hydraulic_table::k_total_disconv,
+      &hydraulic_table::k_total_roughconv, &hydraulic_table::alpha_areaconv,
+      &hydraulic_table::alpha_disconv, &hydraulic_table::alpha_roughconv,
+      &hydraulic_table::nc_equalforce, &hydraulic_table::nc_equalvelocity,
+      &hydraulic_table::nc_wavgwp, &hydraulic_table::nc_wavgarea, &hydraulic_table::nc_wavgconv};
+
+  const hydraulic_table orig = hydtable;
+  int n = std::max((int)std::ceil((orig.depth.back() - orig.depth.front()) / depth_step - 1e-9) + 1, 2);
+  double wsl_step = (orig.wsl_max - orig.wsl_min) / (n - 1);
+
+  hydraulic_table res;
+  for (int k = 0; k < n; k++) {
+    double wsl = k == n - 1 ? orig.wsl_max : orig.wsl_min + k * wsl_step;
+    table_bracket bracket = find_table_bracket(wsl, orig);
+    res.wsl.push_back(wsl);
+    for (auto col : columns) {
+      (res.*col).push_back(interpolate(bracket, col, orig));
+    }
+  }
+  res.wsl_min = orig.wsl_min;
+  res.wsl_max = orig.wsl_max;
+  res.wsl_step = wsl_step > 0 ? wsl_step : PLACEHOLDER;
+  res.depth_step = res.depth.back() > res.depth.front() ? (res.depth.back() - res.depth.front()) / (n - 1) : PLACEHOLDER;
+
+  // piecewise linear tables differ most at their breakpoints, so check at the original rows
+  double max_err = 0.0;
+  for (auto col : columns) {
+    double scale = 0.0;
+    for (double y : orig.*col) {
+      if (y != PLACEHOLDER) {
+        scale = std::max(scale, std::abs(y));
+      }
+    }
+    if (scale == 0.0) {
+      continue;
+    }
+    for (int j = 0; j < orig.wsl.size(); j++) {
+      double y = (orig.*col)[j];
+      double y_res = interpolate(find_table_bracket(orig.wsl[j], res), col, res);
+      if (y == PLACEHOLDER || y_res == PLACEHOLDER) {
+        continue;
+      }
+      max_err = std::max(max_err, std::abs(y_res - y) / scale);
+    }
+  }
+
+  hydtable = res;
+  return max_err;
+}
+
 //////////////////////////////////////////////////////////////////
 /// \brief Returns row of depthdf with depth 'depth'
 ///
@@ -641,7 +1119,7 @@ void CStreamnode::add_sourcesink(int index, double source, double sink) {
 ///
 /// \param upflows [in] flow value contributed by upstream nodes
 //
-void CStreamnode::calc_output_flows(std::vector<double> upflows) {
+void CStreamnode::calc_output_flows(const std::vector<double> &upflows) {
   allocate_flowprofiles(upflows.size());
   for (int k = 0; k < upflows.size(); k++) {
     upstream_flows[k] = upflows[k];
@@ -716,6 +1194,4 @@ CStreamnode::~CStreamnode() {
   }
   delete depthdf;
   depthdf = nullptr;
-  delete mm;
-  mm = nullptr;
 }
@@ -25,6 +25,8 @@ public:
   double bed_slope;                         // bed slope of streamnode
   double sn_roughness_multiplier;           // roughness multiplier for the individual streamnode
   std::vector<hydraulic_output*> *depthdf;  // contains data from the depthdf extracted from input files
+  hydraulic_table hydtable;                 // columnar copy of depthdf used for interpolation, built by build_hydtable
+  normal_depth_rating ndrating;             // rating of wsl versus conveyance used for normal depth lookups, empty unless built by build_normal_depth_rating
   std::vector<double> upstream_flows;       // combined flows from upstream nodes w/o source/sink
   std::vector<double> flow_sources;         // flow sources to be added to upstream_flows
   std::vector<double> flow_sinks;           // flow sinks to be subtracted from upstream_flows
@@ -32,9 +34,6 @@ public:
   std::vector<double> output_depths;        // depths of streamnode for each flow profile
   std::vector<double> output_wsls;          // water surface levels of streamnode for each flow profile
 
-  // For internal use
-  hydraulic_output *mm;
-
   // Constructors and destructor
   CStreamnode();
   CStreamnode(const CStreamnode &other);
@@ -45,31 +44,42 @@ public:
 
   // Functions
   double compute_normal_depth(double flow, double slope, double init_wsl, COptions *bbopt);           // compute wsl based on parameters and streamnode member variables
-  void compute_basic_depth_properties_interpolation(double wsl, COptions*& bbopt);                    // compute basic depth properties with interpolation
-  void compute_profile(double flow, double wsl, COptions *bbopt);                                     // compute profile for streamnode
-  void compute_profile_next(double flow, double wsl, hydraulic_output *down_mm, COptions *bbopt);     // compute profile for next streamnode
-  double get_total_energy(double H, hydraulic_output *down_mm, COptions *&bbopt);                     // compute total energy for streamnode at junction
-  double get_wsl_error(double H, hydraulic_output *down_mm, COptions *&bbopt);						  // compute wsl error for given wsl input
-  double get_wsl_residual(double H, hydraulic_output *down_mm, COptions *&bbopt);					  // compute wsl residual for given wsl input
+  void compute_basic_depth_properties_interpolation(double wsl, hydraulic_output *mm, COptions*& bbopt);                     // compute basic depth properties with interpolation into working state mm
+  void compute_profile(double flow, double wsl, hydraulic_output *mm, COptions *bbopt);                                      // compute profile for streamnode into working state mm
+  void compute_profile_next(double flow, double wsl, hydraulic_output *mm, hydraulic_output *down_mm, COptions *bbopt);      // compute profile for next streamnode into working state mm
+  double get_total_energy(double H, hydraulic_output *mm, hydraulic_output *down_mm, COptions *&bbopt);                      // compute total energy for streamnode at junction
+  double get_wsl_error(double H, hydraulic_output *mm, hydraulic_output *down_mm, COptions *&bbopt);                         // compute wsl error for given wsl input
+  double get_wsl_residual(double H, hydraulic_output *mm, hydraulic_output *down_mm, COptions *&bbopt);                      // compute wsl residual for given wsl input
+
+  hydraulic_state evaluate_profile(double wsl, double flow, const COptions *bbopt) const;                                        // evaluate hydraulic state without modifying streamnode
+  hydraulic_state evaluate_profile_next(double wsl, double flow, const hydraulic_output *down_mm, const COptions *bbopt) const; // evaluate hydraulic state relative to downstream node without modifying streamnode
+  double evaluate_total_energy(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt) const;             // evaluate total energy for given wsl input without modifying streamnode
+  double evaluate_wsl_residual(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt) const;             // evaluate wsl residual for given wsl input without modifying streamnode
+  double evaluate_total_energy(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt, double &dEdH) const; // evaluate total energy and its derivative for given wsl input without modifying streamnode
+  double evaluate_wsl_residual(double H, double flow, const hydraulic_output *down_mm, const COptions *bbopt, double &dRdH) const; // evaluate wsl residual and its derivative for given wsl input without modifying streamnode
     
   double get_area(double depth) const;                  
   double get_topwidth(double depth) const;  
   double get_alpha(double depth) const;  
 
   void add_depthdf_row(hydraulic_output*& row);                                                       // add hydraulic_output row to depthdf
+  void build_hydtable();                                                                              // build hydtable from rows of depthdf
+  double resample_hydtable(double depth_step);                                                        // resample hydtable onto uniform depth grid, returns max interpolation error
+  void build_normal_depth_rating(const COptions *bbopt);                                              // build ndrating from hydtable
+  double lookup_normal_depth(double flow, double slope) const;                                        // normal depth wsl from ndrating, PLACEHOLDER if outside the rating
   hydraulic_output* get_depthdf_row_from_depth(double depth);                                         // get row of depthdf using the depth of the row
 
   void add_steadyflow(double flow);                                                                   // add a steadyflow condition to streamnode
   void add_sourcesink(int index, double source, double sink);                                         // add source and sink pair to streamnode
 
-  void calc_output_flows(std::vector<double> upflows);                                                // calculate output flows of streamnode
+  void calc_output_flows(const std::vector<double> &upflows);                                        // calculate output flows of streamnode
   void calc_output_flows_headwaternode(COptions *&bbopt);										      // calculate output flows of headwater streamnode
 
   void pretty_print() const; // defined in StandardOutput.cpp
 
   // Virtual Functions
-  virtual void compute_basic_depth_properties(double wsl, COptions *&bbopt) {};                       // compute basic streamnode depth properties
-  virtual void compute_basic_flow_properties(double flow, COptions *&bbopt) {};                       // compute basic streamnode flow properties
+  virtual void compute_basic_depth_properties(double wsl, hydraulic_output *mm, COptions *&bbopt) {};  // compute basic streamnode depth properties into working state mm
+  virtual void compute_basic_flow_properties(double flow, hydraulic_output *mm, COptions *&bbopt) {};   // compute basic streamnode flow properties into working state mm
 
 
 protected:
@@ -78,6 +88,8 @@ protected:
 
   // Private functions
   void allocate_flowprofiles(int num_fp);   // if needed, allocates space in flowprofile related variables
+  void evaluate_depth_properties(hydraulic_state &hs, const COptions *bbopt) const;  // fills depth properties of hs by interpolation of depthdf
+  void evaluate_flow_properties(hydraulic_state &hs) const;                         // fills flow properties of hs
 };
 
 #endif
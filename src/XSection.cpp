@@ -51,9 +51,10 @@ CXSection &CXSection::operator=(const CXSection &other) {
 /// \brief Compute basic depth properties
 ///
 /// \param wsl [in] water surface level to be used in computations
+/// \param *mm [in/out] working state of streamnode to fill
 /// \param *&bbopt [in] Global model options information
 //
-void CXSection::compute_basic_depth_properties(double wsl, COptions *&bbopt) {
+void CXSection::compute_basic_depth_properties(double wsl, hydraulic_output *mm, COptions *&bbopt) {
   if (bbopt->manning_enforce_values && (manning_LOB == PLACEHOLDER || manning_main == PLACEHOLDER || manning_ROB == PLACEHOLDER)) {
     WriteWarning("XSection.cpp: compute_basic_depth_properties: "
                  "bbopt->manning_enforce_values is TRUE but one or more Manning "
@@ -533,9 +534,10 @@ void CXSection::compute_basic_depth_properties(double wsl, COptions *&bbopt) {
 /// \brief Compute basic flow properties
 ///
 /// \param flow [in] flow to be used in computations
+/// \param *mm [in/out] working state of streamnode to fill
 /// \param *&bbopt [in] Global model options information
 //
-void CXSection::compute_basic_flow_properties(double flow, COptions *&bbopt) {
+void CXSection::compute_basic_flow_properties(double flow, hydraulic_output *mm, COptions *&bbopt) {
   mm->flow = flow;
   mm->flow_lob = mm->flow * mm->k_lob / mm->k_total;
   mm->flow_main = mm->flow * mm->k_main / mm->k_total;
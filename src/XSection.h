@@ -26,8 +26,8 @@ public:
   CXSection &operator=(const CXSection &other);
 
   // Functions
-  void compute_basic_depth_properties(double wsl, COptions *&bbopt); // computes depth properties for xsection
-  void compute_basic_flow_properties(double flow, COptions *&bbopt); // computes flow properties for xsection
+  void compute_basic_depth_properties(double wsl, hydraulic_output *mm, COptions *&bbopt); // computes depth properties for xsection
+  void compute_basic_flow_properties(double flow, hydraulic_output *mm, COptions *&bbopt); // computes flow properties for xsection
 
   void pretty_print() const; // defined in StandardOutput.cpp
 };